@@ -0,0 +1,143 @@
+/**
+ * @file annexb_bench.cpp
+ * @brief AVCC to Annex-B conversion benchmarks
+ *
+ * Every H.264 packet from an MP4/MKV demuxer is rewritten from AVCC to
+ * Annex-B before decode. Compares the per-NAL append loop the extractor used
+ * to run against the sized and in-place conversions.
+ */
+
+#include "yapl/detail/annexb.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+// Access units shaped like real encodes: an I-frame and a P-frame, each
+// split into slices. range(0) selects 1080p or 4K sizes.
+struct access_unit_shape {
+    size_t keyframe_bytes;
+    size_t inter_bytes;
+    size_t slices;
+};
+
+constexpr access_unit_shape kShapes[] = {
+    {.keyframe_bytes = 200 * 1024, .inter_bytes = 30 * 1024, .slices = 4},
+    {.keyframe_bytes = 800 * 1024, .inter_bytes = 120 * 1024, .slices = 8},
+};
+
+// SEI + slices of payload_bytes in total, each with a nal_length_size prefix
+std::vector<uint8_t> make_access_unit(size_t payload_bytes, size_t slices,
+                                      size_t nal_length_size) {
+    std::vector<size_t> nal_sizes{32};
+    for (size_t i = 0; i < slices; ++i) {
+        nal_sizes.push_back(payload_bytes / slices);
+    }
+    // 1- and 2-byte prefixes cannot describe large slices; split them up
+    const size_t max_nal = (size_t{1} << (8 * nal_length_size)) - 1;
+
+    std::vector<uint8_t> packet;
+    uint8_t fill = 0;
+    for (auto remaining : nal_sizes) {
+        while (remaining > 0) {
+            const auto length = std::min(remaining, max_nal);
+            for (size_t i = nal_length_size; i-- > 0;) {
+                packet.push_back(static_cast<uint8_t>(length >> (8 * i)));
+            }
+            packet.push_back(0x65);
+            packet.insert(packet.end(), length - 1, ++fill);
+            remaining -= length;
+        }
+    }
+    return packet;
+}
+
+// The conversion ffmpeg_media_extractor used before the sized path: one
+// append for the start code and one for the payload, per NAL unit
+void legacy_avcc_to_annexb(size_t nal_length_size,
+                           const std::vector<uint8_t> &packet,
+                           std::vector<uint8_t> &out) {
+    static const uint8_t sc4[4] = {0, 0, 0, 1};
+    const auto *position = packet.data();
+    const auto *end = packet.data() + packet.size();
+    while (position + nal_length_size <= end) {
+        uint32_t size = 0;
+        for (size_t i = 0; i < nal_length_size; ++i) {
+            size = (size << 8) | position[i];
+        }
+        position += nal_length_size;
+        out.insert(out.end(), sc4, sc4 + 4);
+        out.insert(out.end(), position, position + size);
+        position += size;
+    }
+}
+
+template <typename Convert>
+void run_gop(benchmark::State &state, size_t nal_length_size,
+             Convert convert) {
+    const auto &shape = kShapes[state.range(0)];
+    const std::vector<std::vector<uint8_t>> packets = {
+        make_access_unit(shape.keyframe_bytes, shape.slices, nal_length_size),
+        make_access_unit(shape.inter_bytes, shape.slices, nal_length_size),
+    };
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        for (const auto &packet : packets) {
+            // A fresh buffer per packet, as for each media_sample
+            std::vector<uint8_t> out;
+            convert(packet, out);
+            benchmark::DoNotOptimize(out.data());
+            bytes += packet.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * packets.size());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetLabel(state.range(0) == 0 ? "1080p" : "4K");
+}
+} // namespace
+
+/**
+ * @brief Per-NAL append into a growing vector (4-byte lengths)
+ */
+static void BM_AnnexB_Legacy(benchmark::State &state) {
+    run_gop(state, 4, [](const auto &packet, auto &out) {
+        legacy_avcc_to_annexb(4, packet, out);
+    });
+}
+BENCHMARK(BM_AnnexB_Legacy)->Arg(0)->Arg(1);
+
+/**
+ * @brief Single copy then start codes written over the 4-byte prefixes
+ */
+static void BM_AnnexB_InPlace(benchmark::State &state) {
+    run_gop(state, 4, [](const auto &packet, auto &out) {
+        out.assign(packet.begin(), packet.end());
+        out.resize(*avcc_to_annexb_in_place(out));
+    });
+}
+BENCHMARK(BM_AnnexB_InPlace)->Arg(0)->Arg(1);
+
+/**
+ * @brief Per-NAL append with 2-byte lengths, where sizes differ
+ */
+static void BM_AnnexB_Legacy_ShortLength(benchmark::State &state) {
+    run_gop(state, 2, [](const auto &packet, auto &out) {
+        legacy_avcc_to_annexb(2, packet, out);
+    });
+}
+BENCHMARK(BM_AnnexB_Legacy_ShortLength)->Arg(0)->Arg(1);
+
+/**
+ * @brief Size pass, one allocation, then a copy per NAL (2-byte lengths)
+ */
+static void BM_AnnexB_Sized_ShortLength(benchmark::State &state) {
+    run_gop(state, 2, [](const auto &packet, auto &out) {
+        out.resize(*avcc_to_annexb_size(packet, 2));
+        avcc_to_annexb(packet, 2, out);
+    });
+}
+BENCHMARK(BM_AnnexB_Sized_ShortLength)->Arg(0)->Arg(1);
@@ -1,11 +1,12 @@
 /**
  * @file blocking_queue_bench.cpp
- * @brief Performance benchmarks for blocking_queue
+ * @brief Performance benchmarks for blocking_queue and spsc_queue
  *
  * Measures throughput and latency of queue operations under various conditions.
  */
 
 #include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/spsc_queue.hpp"
 #include <benchmark/benchmark.h>
 #include <memory>
 #include <thread>
@@ -198,3 +199,84 @@ static void BM_BlockingQueue_Stats(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_BlockingQueue_Stats)->Arg(60)->Arg(1024);
+
+/**
+ * @brief Contended SPSC hop: blocking_queue vs spsc_queue
+ *
+ * Mirrors a pipeline hop (buffering -> track, decoder -> renderer): one
+ * producer and one consumer thread, both using the blocking push()/pop().
+ */
+template <typename Queue>
+static void BM_Queue_SPSC_Contended(benchmark::State &state) {
+    const size_t queue_size = state.range(0);
+    Queue queue{queue_size};
+
+    std::thread consumer([&]() {
+        while (queue.pop()) {
+        }
+    });
+
+    int value = 0;
+    for (auto _ : state) {
+        queue.push(value++);
+    }
+
+    queue.shutdown();
+    consumer.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Queue_SPSC_Contended, blocking_queue<int>)
+    ->Arg(10)->Arg(60)->Arg(1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Queue_SPSC_Contended, spsc_queue<int>)
+    ->Arg(10)->Arg(60)->Arg(1024)->UseRealTime();
+
+/**
+ * @brief Contended SPSC hop with shared_ptr payloads (track/renderer queues)
+ */
+template <typename Queue>
+static void BM_Queue_SPSC_Contended_SharedPtr(benchmark::State &state) {
+    const size_t queue_size = state.range(0);
+    Queue queue{queue_size};
+    auto frame = std::make_shared<std::vector<uint8_t>>(64);
+
+    std::thread consumer([&]() {
+        while (queue.pop()) {
+        }
+    });
+
+    for (auto _ : state) {
+        queue.push(frame);
+    }
+
+    queue.shutdown();
+    consumer.join();
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Queue_SPSC_Contended_SharedPtr,
+                   blocking_queue<std::shared_ptr<std::vector<uint8_t>>>)
+    ->Arg(10)->Arg(60)->Arg(1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Queue_SPSC_Contended_SharedPtr,
+                   spsc_queue<std::shared_ptr<std::vector<uint8_t>>>)
+    ->Arg(10)->Arg(60)->Arg(1024)->UseRealTime();
+
+/**
+ * @brief Stats query on spsc_queue (lock-free, compare BM_BlockingQueue_Stats)
+ */
+static void BM_SpscQueue_Stats(benchmark::State &state) {
+    const size_t queue_size = state.range(0);
+    spsc_queue<int> queue{queue_size};
+
+    for (size_t i = 0; i < queue_size / 2; ++i) {
+        queue.push(static_cast<int>(i));
+    }
+
+    for (auto _ : state) {
+        auto stats = queue.stats();
+        benchmark::DoNotOptimize(stats);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscQueue_Stats)->Arg(60)->Arg(1024);
@@ -0,0 +1,111 @@
+/**
+ * @file data_source_bench.cpp
+ * @brief Sequential read throughput of the local file data sources
+ *
+ * Reads a 64MB temporary file front to back in fixed-size chunks, the way
+ * the extractor's AVIO callback pulls data, through the ifstream-based
+ * data_sources::file and the memory-mapped data_sources::mapped_file. The
+ * file was just written, so it is served from the page cache: results show
+ * per-read overhead, not disk speed.
+ */
+
+#include "yapl/detail/data_sources/file.hpp"
+#include "yapl/detail/data_sources/mapped_file.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+constexpr size_t kFileSize = 64 * 1024 * 1024;
+constexpr size_t kPageSize = 4096;
+
+// Created on first use, removed at exit
+struct test_file {
+    test_file()
+        : path{std::filesystem::temp_directory_path() /
+               "yapl_data_source_bench.bin"} {
+        std::vector<char> data(kFileSize);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(i * 31);
+        }
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    ~test_file() { std::filesystem::remove(path); }
+
+    std::filesystem::path path;
+};
+
+const std::filesystem::path &test_file_path() {
+    static const test_file file;
+    return file.path;
+}
+} // namespace
+
+/**
+ * @brief read_data() in chunks into a caller buffer, whole file per iteration
+ *
+ * range(0): chunk size in bytes (65536 = the default AVIO buffer,
+ *           extractor_config::io_buffer_size)
+ */
+template <typename Source>
+static void BM_DataSourceRead(benchmark::State &state) {
+    const auto chunk = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> buffer(chunk);
+    Source source{test_file_path()};
+
+    for (auto _ : state) {
+        source.open();
+        while (source.read_data(chunk, buffer) != 0) {
+            benchmark::DoNotOptimize(buffer.data());
+        }
+        source.close();
+    }
+
+    state.SetBytesProcessed(state.iterations() * kFileSize);
+}
+BENCHMARK(BM_DataSourceRead<data_sources::file>)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DataSourceRead<data_sources::mapped_file>)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief consume() without copying, touching one byte per page
+ *
+ * Lower bound for readers that parse straight out of the mapping: only page
+ * faults and read-ahead remain.
+ */
+static void BM_MappedFileConsume(benchmark::State &state) {
+    const auto chunk = static_cast<size_t>(state.range(0));
+    data_sources::mapped_file source{test_file_path()};
+
+    for (auto _ : state) {
+        source.open();
+        uint8_t sum = 0;
+        for (auto data = source.consume(chunk); !data.empty();
+             data = source.consume(chunk)) {
+            for (size_t i = 0; i < data.size(); i += kPageSize) {
+                sum += data[i];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+        source.close();
+    }
+
+    state.SetBytesProcessed(state.iterations() * kFileSize);
+}
+BENCHMARK(BM_MappedFileConsume)
+    ->Arg(4096)
+    ->Arg(32768)
+    ->Unit(benchmark::kMillisecond);
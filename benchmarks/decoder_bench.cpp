@@ -0,0 +1,276 @@
+/**
+ * @file decoder_bench.cpp
+ * @brief Decode-loop benchmarks for the FFmpeg video and audio decoders
+ *
+ * A short H.264 elementary stream (Annex-B, in-band SPS/PPS) and an AAC
+ * stream are synthesized once with FFmpeg's encoders and kept in memory. The
+ * benchmarks replay them through the decoders the way the pipeline's decoder
+ * threads do, so the numbers are codec work plus yapl's per-packet overhead,
+ * with no demuxing or I/O.
+ */
+
+#include "yapl/detail/decoders/ffmpeg/audio_decoder.hpp"
+#include "yapl/detail/decoders/ffmpeg/video_decoder.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
+#include "yapl/track_info.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/opt.h>
+}
+
+using namespace yapl;
+
+namespace {
+constexpr int kVideoWidth = 320;
+constexpr int kVideoHeight = 240;
+constexpr int kVideoFps = 30;
+constexpr int kVideoFrames = 60;
+
+constexpr int kAudioSampleRate = 44100;
+constexpr int kAudioChannels = 2;
+constexpr int kAudioFrames = 100;
+constexpr double kToneHz = 440.0;
+
+struct encoded_stream {
+    std::vector<std::shared_ptr<media_sample>> packets;
+    std::vector<uint8_t> extra_data;
+};
+
+void drain_encoder(AVCodecContext *ctx, AVPacket *pkt, encoded_stream &out) {
+    while (avcodec_receive_packet(ctx, pkt) == 0) {
+        auto sample = std::make_shared<media_sample>();
+        sample->debug_id = out.packets.size();
+        sample->pts = pkt->pts;
+        sample->dts = pkt->dts;
+        sample->data.assign(pkt->data, pkt->data + pkt->size);
+        out.packets.push_back(std::move(sample));
+        av_packet_unref(pkt);
+    }
+}
+
+// Moving gradient, one GOP. Without AV_CODEC_FLAG_GLOBAL_HEADER the encoder
+// emits SPS/PPS in-band, so the stream decodes from its first packet.
+std::optional<encoded_stream> encode_h264() {
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        return std::nullopt;
+    }
+
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    ctx->width = kVideoWidth;
+    ctx->height = kVideoHeight;
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx->time_base = {1, kVideoFps};
+    ctx->framerate = {kVideoFps, 1};
+    ctx->gop_size = kVideoFrames;
+    ctx->max_b_frames = 0;
+    // libx264 only; other encoders ignore the unknown option
+    av_opt_set(ctx->priv_data, "preset", "ultrafast", 0);
+    if (avcodec_open2(ctx, codec, nullptr) < 0) {
+        avcodec_free_context(&ctx);
+        return std::nullopt;
+    }
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = ctx->pix_fmt;
+    frame->width = ctx->width;
+    frame->height = ctx->height;
+    av_frame_get_buffer(frame, 0);
+    AVPacket *pkt = av_packet_alloc();
+
+    encoded_stream out;
+    for (int i = 0; i < kVideoFrames; ++i) {
+        av_frame_make_writable(frame);
+        for (int y = 0; y < kVideoHeight; ++y) {
+            for (int x = 0; x < kVideoWidth; ++x) {
+                frame->data[0][y * frame->linesize[0] + x] =
+                    static_cast<uint8_t>(x + y + i * 3);
+            }
+        }
+        for (int y = 0; y < kVideoHeight / 2; ++y) {
+            for (int x = 0; x < kVideoWidth / 2; ++x) {
+                frame->data[1][y * frame->linesize[1] + x] =
+                    static_cast<uint8_t>(128 + i);
+                frame->data[2][y * frame->linesize[2] + x] =
+                    static_cast<uint8_t>(64 + i);
+            }
+        }
+        frame->pts = i;
+        avcodec_send_frame(ctx, frame);
+        drain_encoder(ctx, pkt, out);
+    }
+    avcodec_send_frame(ctx, nullptr);
+    drain_encoder(ctx, pkt, out);
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return out;
+}
+
+// 440Hz stereo tone through FFmpeg's native AAC encoder. The
+// AudioSpecificConfig it produces becomes the decoder's extra data.
+std::optional<encoded_stream> encode_aac() {
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_AAC);
+    if (!codec) {
+        return std::nullopt;
+    }
+
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    ctx->sample_fmt = AV_SAMPLE_FMT_FLTP;
+    ctx->sample_rate = kAudioSampleRate;
+    ctx->bit_rate = 128000;
+    ctx->time_base = {1, kAudioSampleRate};
+    av_channel_layout_default(&ctx->ch_layout, kAudioChannels);
+    if (avcodec_open2(ctx, codec, nullptr) < 0) {
+        avcodec_free_context(&ctx);
+        return std::nullopt;
+    }
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = ctx->sample_fmt;
+    frame->nb_samples = ctx->frame_size;
+    frame->sample_rate = ctx->sample_rate;
+    av_channel_layout_copy(&frame->ch_layout, &ctx->ch_layout);
+    av_frame_get_buffer(frame, 0);
+    AVPacket *pkt = av_packet_alloc();
+
+    encoded_stream out;
+    for (int i = 0; i < kAudioFrames; ++i) {
+        av_frame_make_writable(frame);
+        for (int ch = 0; ch < kAudioChannels; ++ch) {
+            auto *samples = reinterpret_cast<float *>(frame->data[ch]);
+            for (int n = 0; n < frame->nb_samples; ++n) {
+                const double t =
+                    static_cast<double>(i * frame->nb_samples + n) /
+                    kAudioSampleRate;
+                samples[n] = static_cast<float>(
+                    0.5 * std::sin(2.0 * std::numbers::pi * kToneHz * t));
+            }
+        }
+        frame->pts = static_cast<int64_t>(i) * frame->nb_samples;
+        avcodec_send_frame(ctx, frame);
+        drain_encoder(ctx, pkt, out);
+    }
+    avcodec_send_frame(ctx, nullptr);
+    drain_encoder(ctx, pkt, out);
+    out.extra_data.assign(ctx->extradata,
+                          ctx->extradata + ctx->extradata_size);
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    return out;
+}
+
+const std::optional<encoded_stream> &h264_stream() {
+    static const auto stream = encode_h264();
+    return stream;
+}
+
+const std::optional<encoded_stream> &aac_stream() {
+    static const auto stream = encode_aac();
+    return stream;
+}
+
+template <typename Decoder, typename... Options>
+void run_decode_loop(benchmark::State &state, const encoded_stream &stream,
+                     AVCodecID codec_id, const Options &...options) {
+    auto extra_data = stream.extra_data;
+    Decoder decoder{codec_id, std::span<uint8_t>{extra_data}, options...};
+    auto info = std::make_shared<track_info>();
+
+    size_t frames = 0;
+    const decoders::frame_callback on_frame =
+        [&frames](std::shared_ptr<media_sample> frame) {
+            benchmark::DoNotOptimize(frame.get());
+            ++frames;
+        };
+
+    // One pass over the stream per iteration, drained like the pipeline does
+    // at end of stream so frame-threaded decoders don't carry frames over
+    for (auto _ : state) {
+        for (const auto &packet : stream.packets) {
+            decoder.decode(info, packet, on_frame);
+        }
+        decoder.flush(on_frame);
+    }
+
+    state.SetItemsProcessed(state.iterations() * stream.packets.size());
+    state.counters["frames"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+} // namespace
+
+/**
+ * @brief Decode the synthetic H.264 stream, one decode() call per packet
+ * plus a flush() per pass
+ *
+ * range(0): decoder thread count (0 = codec picks)
+ * range(1): decoder_thread_type (0 = automatic, 1 = frame, 2 = slice)
+ */
+static void BM_DecodeLoop_H264(benchmark::State &state) {
+    const auto &stream = h264_stream();
+    if (!stream || stream->packets.empty()) {
+        state.SkipWithError("FFmpeg build has no usable H.264 encoder");
+        return;
+    }
+    const decoder_threading threading{
+        .thread_count = static_cast<size_t>(state.range(0)),
+        .thread_type = static_cast<decoder_thread_type>(state.range(1))};
+    run_decode_loop<decoders::ffmpeg::video_decoder>(
+        state, *stream, AV_CODEC_ID_H264, threading);
+}
+BENCHMARK(BM_DecodeLoop_H264)
+    ->ArgNames({"threads", "type"})
+    ->Args({1, 0})
+    ->Args({0, 0})
+    ->Args({2, 1})
+    ->Args({4, 1})
+    ->Args({2, 2})
+    ->Args({4, 2})
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Decode the synthetic AAC stream, one decode() call per packet
+ */
+static void BM_DecodeLoop_AAC(benchmark::State &state) {
+    const auto &stream = aac_stream();
+    if (!stream || stream->packets.empty()) {
+        state.SkipWithError("FFmpeg build has no usable AAC encoder");
+        return;
+    }
+    run_decode_loop<decoders::ffmpeg::audio_decoder>(state, *stream,
+                                                     AV_CODEC_ID_AAC);
+}
+BENCHMARK(BM_DecodeLoop_AAC)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Per-packet AVPacket/AVFrame allocation the decoders used to pay
+ *
+ * Baseline for the overhead removed by keeping one packet and one frame per
+ * decoder.
+ */
+static void BM_DecoderPacketFrameAlloc(benchmark::State &state) {
+    for (auto _ : state) {
+        AVPacket *packet = av_packet_alloc();
+        AVFrame *frame = av_frame_alloc();
+        benchmark::DoNotOptimize(packet);
+        benchmark::DoNotOptimize(frame);
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecoderPacketFrameAlloc);
@@ -5,6 +5,7 @@
  * Measures allocation patterns and memory usage for media frames.
  */
 
+#include "yapl/detail/frame_pool.hpp"
 #include "yapl/media_sample.hpp"
 #include <benchmark/benchmark.h>
 #include <memory>
@@ -12,6 +13,19 @@
 
 using namespace yapl;
 
+namespace {
+// range(0) selects the resolution for the acquire/release benchmarks
+constexpr frame_key kResolutions[] = {
+    {.format = sample_format::yuv420p, .width = 1280, .height = 720},
+    {.format = sample_format::yuv420p, .width = 1920, .height = 1080},
+    {.format = sample_format::yuv420p, .width = 3840, .height = 2160},
+};
+
+constexpr size_t yuv420p_size(const frame_key &key) {
+    return key.width * key.height * 3 / 2;
+}
+} // namespace
+
 /**
  * @brief Benchmark frame allocation (1080p YUV420)
  */
@@ -196,3 +210,105 @@ static void BM_MediaSample_StructSize(benchmark::State &state) {
     state.SetItemsProcessed(state.iterations());
 }
 BENCHMARK(BM_MediaSample_StructSize);
+
+/**
+ * @brief Decoder-side frame acquire/release without pooling
+ *
+ * What the pipeline did per decoded frame before frame_pool: a fresh
+ * media_sample plus a zero-filled buffer. range(1) frames are kept in flight,
+ * as with a renderer queue holding references.
+ */
+static void BM_FrameAcquireRelease_Unpooled(benchmark::State &state) {
+    const auto &key = kResolutions[state.range(0)];
+    const size_t frame_size = yuv420p_size(key);
+    std::vector<std::shared_ptr<media_sample>> in_flight(state.range(1));
+
+    size_t index = 0;
+    for (auto _ : state) {
+        auto frame = std::make_shared<media_sample>();
+        frame->data.resize(frame_size);
+        benchmark::DoNotOptimize(frame->data.data());
+        in_flight[index++ % in_flight.size()] = std::move(frame);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * frame_size);
+}
+BENCHMARK(BM_FrameAcquireRelease_Unpooled)
+    ->ArgNames({"res", "in_flight"})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Args({1, 60});
+
+/**
+ * @brief Decoder-side frame acquire/release through frame_pool
+ *
+ * Same access pattern as the unpooled case; once the in-flight window has
+ * been filled every acquire is served from the free list.
+ */
+static void BM_FrameAcquireRelease_Pooled(benchmark::State &state) {
+    const auto &key = kResolutions[state.range(0)];
+    const size_t frame_size = yuv420p_size(key);
+    std::vector<std::shared_ptr<media_sample>> in_flight(state.range(1));
+    frame_pool pool;
+
+    size_t index = 0;
+    for (auto _ : state) {
+        auto frame = pool.acquire(key, frame_size);
+        benchmark::DoNotOptimize(frame->data.data());
+        in_flight[index++ % in_flight.size()] = std::move(frame);
+    }
+
+    state.counters["allocations"] =
+        static_cast<double>(pool.stats().allocations);
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * frame_size);
+}
+BENCHMARK(BM_FrameAcquireRelease_Pooled)
+    ->ArgNames({"res", "in_flight"})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Args({1, 60});
+
+/**
+ * @brief Decoder-side acquire/release of a referenced-plane video frame
+ *
+ * Mirrors the FFmpeg video decoder: the sample carries no data buffer, and
+ * a stand-in for the AVFrame shell is attached only when the recycled sample
+ * does not already hold one. "shells" counts the shells created; it stops
+ * growing once the in-flight window is filled. What is left per frame is the
+ * AVBufferRef libavcodec allocates when it hands out a picture buffer.
+ */
+static void BM_FrameAcquireRelease_PooledPlanes(benchmark::State &state) {
+    const auto &key = kResolutions[state.range(0)];
+    std::vector<std::shared_ptr<media_sample>> in_flight(state.range(1));
+    std::vector<uint8_t> picture(yuv420p_size(key));
+    frame_pool pool;
+
+    size_t index = 0;
+    size_t shells = 0;
+    for (auto _ : state) {
+        auto frame = pool.acquire(key, 0);
+        auto &planes = frame->planes;
+        if (!planes.owner) {
+            planes.owner = std::make_shared<int>(0);
+            planes.release = [](void *) {};
+            ++shells;
+        }
+        planes.data[0] = picture.data();
+        planes.linesize[0] = static_cast<int>(key.width);
+        benchmark::DoNotOptimize(planes.data[0]);
+        in_flight[index++ % in_flight.size()] = std::move(frame);
+    }
+
+    state.counters["allocations"] =
+        static_cast<double>(pool.stats().allocations);
+    state.counters["shells"] = static_cast<double>(shells);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FrameAcquireRelease_PooledPlanes)
+    ->ArgNames({"res", "in_flight"})
+    ->Args({1, 1})
+    ->Args({1, 60});
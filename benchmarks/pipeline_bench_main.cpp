@@ -0,0 +1,161 @@
+/**
+ * @file pipeline_bench_main.cpp
+ * @brief Plays a file through the real extractor and decoders into the null
+ *        renderers and reports throughput
+ *
+ * Needs no display or sound card, so it runs on CI machines. With the default
+ * "fast" pacing frames are consumed as soon as they are decoded, which
+ * measures demux + decode throughput; "clock" pacing plays in real time;
+ * "free" paces on a free-running clock, keeping A/V ordering at decoder speed.
+ *
+ * Usage: yapl_bench_pipeline <media_file_or_url> [fast|clock|free] [threads]
+ */
+
+#include "yapl/decoders/ffmpeg/ffmpeg_decoder_factory.hpp"
+#include "yapl/detail/debug.hpp"
+#include "yapl/detail/media_pipeline.hpp"
+#include "yapl/detail/utilities.hpp"
+#include "yapl/ffmpeg_media_extractor_factory.hpp"
+#include "yapl/input/i_input_handler_factory.hpp"
+#include "yapl/media_source_factory.hpp"
+#include "yapl/renderers/null/audio_renderer_factory.hpp"
+#include "yapl/renderers/null/video_renderer_factory.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+using namespace yapl;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto kPollInterval = 5ms;
+
+// Quits playback from the render loop once asked to, so stop() runs on the
+// thread that called play()
+struct quit_on_request : input::i_input_handler {
+    explicit quit_on_request(const std::atomic_bool &requested)
+        : m_requested{requested} {}
+
+    void poll() override {
+        if (m_requested && m_callback) {
+            m_callback(input::command::quit);
+        }
+    }
+    void set_command_callback(input::command_callback callback) override {
+        m_callback = std::move(callback);
+    }
+
+  private:
+    const std::atomic_bool &m_requested;
+    input::command_callback m_callback;
+};
+
+struct quit_on_request_factory : input::i_input_handler_factory {
+    explicit quit_on_request_factory(const std::atomic_bool &requested)
+        : m_requested{requested} {}
+
+    std::unique_ptr<input::i_input_handler> create() override {
+        return std::make_unique<quit_on_request>(m_requested);
+    }
+
+  private:
+    const std::atomic_bool &m_requested;
+};
+
+// Everything decoded and consumed by the renderers
+bool playback_finished(const pipeline_stats &stats) {
+    return stats.progress.end_of_stream && stats.video_renderer_queue.size == 0 &&
+           stats.audio_renderer_queue.size == 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        LOG_ERROR("Usage: {} <media_file_or_url> [fast|clock|free] [threads]",
+                  argv[0]);
+        return 1;
+    }
+    const std::string_view url = argv[1];
+    const std::string_view mode = argc > 2 ? argv[2] : "fast";
+
+    pipeline_config config;
+    auto pacing = renderers::null::render_pacing::as_fast_as_possible;
+    if (mode == "clock" || mode == "free") {
+        pacing = renderers::null::render_pacing::clock;
+    }
+    if (mode == "free") {
+        config.playback_clock = clock_mode::free_running;
+    }
+    if (argc > 3) {
+        config.video_decoder_threading.thread_count =
+            static_cast<size_t>(std::strtoul(argv[3], nullptr, 10));
+    }
+
+    std::atomic_bool quit_requested{false};
+    media_pipeline pipeline{
+        std::make_unique<media_source_factory>(),
+        std::make_unique<ffmpeg_media_extractor_factory>(),
+        std::make_unique<decoders::ffmpeg::ffmpeg_decoder_factory>(),
+        std::make_unique<renderers::null::video_renderer_factory>(pacing),
+        std::make_unique<renderers::null::audio_renderer_factory>(pacing),
+        std::make_unique<quit_on_request_factory>(quit_requested),
+        config};
+    pipeline.set_command_callback([&](input::command cmd) {
+        if (cmd == input::command::quit) {
+            pipeline.stop();
+        }
+    });
+
+    pipeline.load(url);
+
+    using clock = std::chrono::steady_clock;
+    const auto started = clock::now();
+    pipeline_stats stats;
+    clock::time_point finished;
+    std::jthread monitor([&](std::stop_token st) {
+        while (!st.stop_requested()) {
+            stats = pipeline.get_stats();
+            if (playback_finished(stats)) {
+                finished = clock::now();
+                quit_requested = true;
+                return;
+            }
+            std::this_thread::sleep_for(kPollInterval);
+        }
+    });
+    pipeline.play();
+    monitor.join();
+
+    const auto elapsed_us = utilities::elapsed_us(started, finished);
+    const double seconds = static_cast<double>(elapsed_us) / 1e6;
+    const auto &playback = stats.playback;
+
+    LOG_INFO("Pacing: {}, clock: {}, decoder threads: {}",
+             renderers::null::render_pacing_to_string(pacing),
+             clock_mode_to_string(config.playback_clock),
+             config.video_decoder_threading.thread_count);
+    LOG_INFO("Elapsed: {:.3f}s", seconds);
+    LOG_INFO("Video: {} frames, {:.1f} frames/s ({} late)",
+             playback.video.rendered,
+             static_cast<double>(playback.video.rendered) / seconds,
+             playback.video.dropped_late);
+    LOG_INFO("Audio: {} frames, {:.1f} frames/s ({} late)",
+             playback.audio.rendered,
+             static_cast<double>(playback.audio.rendered) / seconds,
+             playback.audio.dropped_late);
+
+    std::error_code ec;
+    const auto input_bytes = std::filesystem::file_size(argv[1], ec);
+    if (!ec) {
+        LOG_INFO("Input: {} bytes, {:.2f} MB/s", input_bytes,
+                 static_cast<double>(input_bytes) / seconds / 1024.0 / 1024.0);
+    }
+    LOG_INFO("Stats: {}", stats.to_string());
+    return 0;
+}
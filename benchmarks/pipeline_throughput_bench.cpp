@@ -0,0 +1,241 @@
+/**
+ * @file pipeline_throughput_bench.cpp
+ * @brief Packet throughput of a running media_pipeline through the
+ *        buffering -> track -> decoder hop
+ *
+ * The pipeline runs its real buffering and video decoder threads and its
+ * real render loop. Only the ends are synthetic: an extractor that hands out
+ * packets as fast as it is asked, and a decoder that counts them without
+ * producing frames. The time from the first read_sample() to the decoder's
+ * end-of-stream flush is what the pipeline's own pacing costs per packet.
+ */
+
+#include "yapl/decoders/i_decoder.hpp"
+#include "yapl/decoders/i_decoder_factory.hpp"
+#include "yapl/detail/media_pipeline.hpp"
+#include "yapl/i_media_extractor.hpp"
+#include "yapl/i_media_extractor_factory.hpp"
+#include "yapl/i_media_source.hpp"
+#include "yapl/i_media_source_factory.hpp"
+#include "yapl/input/i_input_handler.hpp"
+#include "yapl/input/i_input_handler_factory.hpp"
+#include "yapl/media_info.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
+#include "yapl/renderers/null/audio_renderer_factory.hpp"
+#include "yapl/renderers/null/video_renderer_factory.hpp"
+#include "yapl/track_info.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+
+using namespace yapl;
+
+namespace {
+constexpr size_t kPacketsPerIteration = 4096;
+constexpr size_t kPacketSize = 4096;
+
+// Shared between the benchmark thread and the pipeline's threads
+struct throughput_probe {
+    std::chrono::steady_clock::time_point first_read;
+    std::chrono::steady_clock::time_point drained;
+    std::atomic<size_t> decoded{0};
+    std::atomic_bool done{false};
+};
+
+struct null_source : i_media_source {
+    void open(const std::string_view) override {}
+    void close() override {}
+    size_t read_packet(size_t, std::span<uint8_t>) override { return 0; }
+    size_t available() const override { return 0; }
+    void reset() override {}
+    bool seek(size_t) override { return false; }
+    std::optional<size_t> size() const override { return std::nullopt; }
+};
+
+struct null_source_factory : i_media_source_factory {
+    std::shared_ptr<i_media_source> create(const source_config &) override {
+        return std::make_shared<null_source>();
+    }
+};
+
+// One video track of kPacketsPerIteration packets, then end of stream
+struct synthetic_extractor : i_media_extractor {
+    explicit synthetic_extractor(throughput_probe &probe) : m_probe{probe} {}
+
+    void start() override {
+        auto video = std::make_shared<track_info>();
+        video->type = track_type::video;
+        video->track_id = 0;
+        video->video = std::make_shared<video_track_uniques>(
+            video_track_uniques{.width = 1920,
+                                .height = 1080,
+                                .frame_rate = 30,
+                                .bit_rate = 0,
+                                .extra_data =
+                                    std::make_shared<video_extra_data>(
+                                        video_codec::unknown,
+                                        std::span<const uint8_t>{})});
+
+        m_info = std::make_shared<media_info>();
+        m_info->number_of_tracks = 1;
+        m_info->tracks.push_back(video);
+
+        m_packet = std::make_shared<media_sample>();
+        m_packet->data.resize(kPacketSize);
+    }
+
+    std::shared_ptr<media_info> get_media_info() const override {
+        return m_info;
+    }
+
+    read_sample_result read_sample() override {
+        if (m_next_packet == 0) {
+            m_probe.first_read = std::chrono::steady_clock::now();
+        }
+        if (m_next_packet >= kPacketsPerIteration) {
+            return {.stream_id = 0,
+                    .error = read_sample_error_t::end_of_stream,
+                    .sample = {}};
+        }
+        ++m_next_packet;
+        return {.stream_id = 0,
+                .error = read_sample_error_t::no_errror,
+                .sample = m_packet};
+    }
+
+    bool seek(int64_t) override { return false; }
+    keyframe_index get_keyframe_index(size_t) const override { return {}; }
+    extractor_startup_stats get_startup_stats() const override { return {}; }
+
+    throughput_probe &m_probe;
+    std::shared_ptr<media_info> m_info;
+    std::shared_ptr<media_sample> m_packet;
+    size_t m_next_packet{0};
+};
+
+struct synthetic_extractor_factory : i_media_extractor_factory {
+    explicit synthetic_extractor_factory(throughput_probe &probe)
+        : m_probe{probe} {}
+    std::unique_ptr<i_media_extractor>
+    create(std::shared_ptr<i_media_source>,
+           const extractor_config &) override {
+        return std::make_unique<synthetic_extractor>(m_probe);
+    }
+    throughput_probe &m_probe;
+};
+
+// Counts packets; the end-of-stream flush marks the run as drained
+struct counting_decoder : decoders::i_decoder {
+    explicit counting_decoder(throughput_probe &probe) : m_probe{probe} {}
+
+    bool decode(std::shared_ptr<track_info>,
+                std::shared_ptr<media_sample> sample,
+                const decoders::frame_callback &) override {
+        benchmark::DoNotOptimize(sample->data.data());
+        m_probe.decoded.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    bool flush(const decoders::frame_callback &) override {
+        m_probe.drained = std::chrono::steady_clock::now();
+        m_probe.done = true;
+        return true;
+    }
+    void reset() override {}
+
+    throughput_probe &m_probe;
+};
+
+struct counting_decoder_factory : decoders::i_decoder_factory {
+    explicit counting_decoder_factory(throughput_probe &probe)
+        : m_probe{probe} {}
+    std::unique_ptr<decoders::i_decoder>
+    create_video_decoder(size_t, std::span<uint8_t>,
+                         const decoder_threading &) override {
+        return std::make_unique<counting_decoder>(m_probe);
+    }
+    std::unique_ptr<decoders::i_decoder>
+    create_audio_decoder(size_t, std::span<uint8_t>) override {
+        return std::make_unique<counting_decoder>(m_probe);
+    }
+    throughput_probe &m_probe;
+};
+
+// Quits from the render loop once the decoder has drained
+struct quit_when_drained : input::i_input_handler {
+    explicit quit_when_drained(throughput_probe &probe) : m_probe{probe} {}
+    void poll() override {
+        if (m_probe.done && m_callback) {
+            m_callback(input::command::quit);
+        }
+    }
+    void set_command_callback(input::command_callback callback) override {
+        m_callback = std::move(callback);
+    }
+    throughput_probe &m_probe;
+    input::command_callback m_callback;
+};
+
+struct quit_when_drained_factory : input::i_input_handler_factory {
+    explicit quit_when_drained_factory(throughput_probe &probe)
+        : m_probe{probe} {}
+    std::unique_ptr<input::i_input_handler> create() override {
+        return std::make_unique<quit_when_drained>(m_probe);
+    }
+    throughput_probe &m_probe;
+};
+} // namespace
+
+/**
+ * @brief Packets per second from the extractor into the video decoder
+ *
+ * range(0): track queue_kind (0 = blocking, 1 = spsc)
+ *
+ * Each iteration loads and plays a fresh pipeline; only the span from the
+ * first demuxed packet to the decoder's end-of-stream flush is timed.
+ */
+static void BM_PacketThroughput(benchmark::State &state) {
+    pipeline_config config;
+    config.track_queue_kind = static_cast<queue_kind>(state.range(0));
+    const auto pacing = renderers::null::render_pacing::as_fast_as_possible;
+
+    for (auto _ : state) {
+        throughput_probe probe;
+        media_pipeline pipeline{
+            std::make_unique<null_source_factory>(),
+            std::make_unique<synthetic_extractor_factory>(probe),
+            std::make_unique<counting_decoder_factory>(probe),
+            std::make_unique<renderers::null::video_renderer_factory>(pacing),
+            std::make_unique<renderers::null::audio_renderer_factory>(pacing),
+            std::make_unique<quit_when_drained_factory>(probe),
+            config};
+        pipeline.set_command_callback([&](input::command cmd) {
+            if (cmd == input::command::quit) {
+                pipeline.stop();
+            }
+        });
+        pipeline.load("synthetic://throughput");
+        pipeline.play();
+
+        if (probe.decoded != kPacketsPerIteration) {
+            state.SkipWithError("Decoder did not receive every packet");
+            break;
+        }
+        state.SetIterationTime(
+            std::chrono::duration<double>(probe.drained - probe.first_read)
+                .count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+    state.SetBytesProcessed(state.iterations() * kPacketsPerIteration *
+                            kPacketSize);
+}
+BENCHMARK(BM_PacketThroughput)
+    ->ArgNames({"spsc"})
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
@@ -0,0 +1,378 @@
+/**
+ * @file seek_bench.cpp
+ * @brief Seek latency through a running media_pipeline
+ *
+ * The pipeline runs with synthetic components: an extractor producing a
+ * 30fps video track with one keyframe per second, a decoder that spends a
+ * fixed amount of CPU per packet, and renderers that only queue frames. Each
+ * iteration seeks from the render thread, the way the player's command
+ * callback does, and measures the time until the first frame of the new
+ * position reaches the video renderer.
+ *
+ * This covers quiescing and restarting the worker threads, flushing the
+ * queues and the decode work each seek mode implies, but no real I/O or
+ * container parsing.
+ */
+
+#include "yapl/decoders/i_decoder.hpp"
+#include "yapl/decoders/i_decoder_factory.hpp"
+#include "yapl/detail/media_pipeline.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
+#include "yapl/i_media_extractor.hpp"
+#include "yapl/i_media_extractor_factory.hpp"
+#include "yapl/i_media_source.hpp"
+#include "yapl/i_media_source_factory.hpp"
+#include "yapl/input/i_input_handler.hpp"
+#include "yapl/input/i_input_handler_factory.hpp"
+#include "yapl/media_info.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
+#include "yapl/renderers/i_audio_renderer.hpp"
+#include "yapl/renderers/i_audio_renderer_factory.hpp"
+#include "yapl/renderers/i_video_renderer.hpp"
+#include "yapl/renderers/i_video_renderer_factory.hpp"
+#include "yapl/seek_mode.hpp"
+#include "yapl/track_info.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace yapl;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int64_t kFrameRate = 30;
+constexpr int64_t kGopFrames = 30;
+constexpr int64_t kStreamFrames = kFrameRate * 600;
+constexpr auto kDecodeCost = 1ms;
+constexpr size_t kPacketSize = 1024;
+
+// Minimal avcC record: one SPS, one PPS
+std::vector<uint8_t> kAvcConfig{0x01, 0x42, 0x00, 0x1e, 0xff, 0xe1, 0x00,
+                                0x01, 0x67, 0x01, 0x00, 0x01, 0x68};
+
+constexpr int64_t frame_pts_ms(int64_t frame) {
+    return frame * 1000 / kFrameRate;
+}
+
+void spin_for(std::chrono::nanoseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+struct null_source : i_media_source {
+    void open(const std::string_view) override {}
+    void close() override {}
+    size_t read_packet(size_t, std::span<uint8_t>) override { return 0; }
+    size_t available() const override { return 0; }
+    void reset() override {}
+    bool seek(size_t) override { return false; }
+    std::optional<size_t> size() const override { return std::nullopt; }
+};
+
+struct null_source_factory : i_media_source_factory {
+    std::shared_ptr<i_media_source> create(const source_config &) override {
+        return std::make_shared<null_source>();
+    }
+};
+
+// Shared between the benchmark thread and the pipeline's threads
+struct seek_probe {
+    std::atomic<int64_t> target_ms{-1};
+    std::atomic_bool quit{false};
+    // Bumped by every extractor seek and carried by packets and frames in
+    // debug_id, so frames decoded before the seek are not mistaken for the
+    // first one after it
+    std::atomic<size_t> generation{0};
+    // Generation of the seek being measured
+    std::atomic<size_t> measured_generation{0};
+    std::atomic_bool recorded{true};
+    std::chrono::steady_clock::time_point requested;
+    std::chrono::steady_clock::time_point first_frame;
+    std::atomic<int64_t> first_frame_pts{-1};
+};
+
+// One video track; seek() lands on the keyframe at or before the target
+struct synthetic_extractor : i_media_extractor {
+    explicit synthetic_extractor(seek_probe &probe) : m_probe{probe} {}
+
+    void start() override {
+        auto video = std::make_shared<track_info>();
+        video->type = track_type::video;
+        video->track_id = 0;
+        video->video = std::make_shared<video_track_uniques>(
+            video_track_uniques{.width = 1920,
+                                .height = 1080,
+                                .frame_rate = kFrameRate,
+                                .bit_rate = 0,
+                                .extra_data =
+                                    std::make_shared<video_extra_data>(
+                                        video_codec::h264, kAvcConfig)});
+
+        m_info = std::make_shared<media_info>();
+        m_info->number_of_tracks = 1;
+        m_info->duration = frame_pts_ms(kStreamFrames) * 1000;
+        m_info->tracks.push_back(video);
+
+        m_packet = std::make_shared<media_sample>();
+        m_packet->data.resize(kPacketSize);
+
+        for (int64_t frame = 0; frame < kStreamFrames; frame += kGopFrames) {
+            m_keyframes.add({.pts_ms = frame_pts_ms(frame)});
+        }
+        m_keyframes.set_from_container(true);
+    }
+
+    std::shared_ptr<media_info> get_media_info() const override {
+        return m_info;
+    }
+
+    read_sample_result read_sample() override {
+        if (m_next_frame >= kStreamFrames) {
+            return {.stream_id = 0,
+                    .error = read_sample_error_t::end_of_stream,
+                    .sample = {}};
+        }
+        auto sample = std::make_shared<media_sample>(*m_packet);
+        sample->pts = frame_pts_ms(m_next_frame);
+        sample->dts = sample->pts;
+        sample->keyframe = m_next_frame % kGopFrames == 0;
+        sample->debug_id = m_probe.generation;
+        ++m_next_frame;
+        return {.stream_id = 0,
+                .error = read_sample_error_t::no_errror,
+                .sample = std::move(sample)};
+    }
+
+    bool seek(int64_t position_ms) override {
+        const int64_t frame = position_ms * kFrameRate / 1000;
+        m_next_frame = frame - frame % kGopFrames;
+        ++m_probe.generation;
+        return true;
+    }
+
+    keyframe_index get_keyframe_index(size_t) const override {
+        return m_keyframes;
+    }
+
+    extractor_startup_stats get_startup_stats() const override { return {}; }
+
+    seek_probe &m_probe;
+    std::shared_ptr<media_info> m_info;
+    keyframe_index m_keyframes;
+    std::shared_ptr<media_sample> m_packet;
+    int64_t m_next_frame{0};
+};
+
+struct synthetic_extractor_factory : i_media_extractor_factory {
+    explicit synthetic_extractor_factory(seek_probe &probe) : m_probe{probe} {}
+    std::unique_ptr<i_media_extractor>
+    create(std::shared_ptr<i_media_source>,
+           const extractor_config &) override {
+        return std::make_unique<synthetic_extractor>(m_probe);
+    }
+    seek_probe &m_probe;
+};
+
+// One frame per packet after kDecodeCost of CPU work
+struct synthetic_decoder : decoders::i_decoder {
+    bool decode(std::shared_ptr<track_info>,
+                std::shared_ptr<media_sample> sample,
+                const decoders::frame_callback &on_frame) override {
+        spin_for(kDecodeCost);
+        auto frame = std::make_shared<media_sample>();
+        frame->debug_id = sample->debug_id;
+        frame->pts = sample->pts;
+        on_frame(std::move(frame));
+        return true;
+    }
+    bool flush(const decoders::frame_callback &) override { return true; }
+    void reset() override {}
+};
+
+struct synthetic_decoder_factory : decoders::i_decoder_factory {
+    std::unique_ptr<decoders::i_decoder>
+    create_video_decoder(size_t, std::span<uint8_t>,
+                         const decoder_threading &) override {
+        return std::make_unique<synthetic_decoder>();
+    }
+    std::unique_ptr<decoders::i_decoder>
+    create_audio_decoder(size_t, std::span<uint8_t>) override {
+        return std::make_unique<synthetic_decoder>();
+    }
+};
+
+struct probe_video_renderer : renderers::i_video_renderer {
+    probe_video_renderer(seek_probe &probe, size_t queue_size,
+                         queue_kind kind)
+        : m_probe{probe}, m_frames{queue_size, kind} {}
+
+    void resize(size_t, size_t) override {}
+    void push_frame(std::shared_ptr<media_sample> frame) override {
+        if (frame->debug_id == m_probe.measured_generation &&
+            !m_probe.recorded.exchange(true)) {
+            m_probe.first_frame = std::chrono::steady_clock::now();
+            m_probe.first_frame_pts = frame->pts;
+            m_probe.first_frame_pts.notify_one();
+        }
+        m_frames.push(frame);
+    }
+    void render() override {
+        while (m_frames.try_pop()) {
+        }
+    }
+    void pause() override {}
+    void resume() override {}
+    void stop() override { m_frames.shutdown(); }
+    void flush() override {
+        while (m_frames.try_pop()) {
+        }
+    }
+    queue_stats get_queue_stats() const override { return m_frames.stats(); }
+    int64_t get_current_position_ms() const override { return 0; }
+    std::optional<int64_t> get_next_frame_due_ms() const override {
+        return std::nullopt;
+    }
+    std::optional<std::chrono::steady_clock::time_point>
+    get_first_frame_time() const override {
+        return std::nullopt;
+    }
+    video_render_latency get_latency_stats() const override { return {}; }
+    video_render_counters get_render_counters() const override { return {}; }
+
+    seek_probe &m_probe;
+    pipeline_queue<std::shared_ptr<media_sample>> m_frames;
+};
+
+struct probe_video_renderer_factory : renderers::i_video_renderer_factory {
+    explicit probe_video_renderer_factory(seek_probe &probe) : m_probe{probe} {}
+    std::unique_ptr<renderers::i_video_renderer>
+    create_video_renderer(renderers::media_clock &, size_t queue_size,
+                          queue_kind kind) override {
+        return std::make_unique<probe_video_renderer>(m_probe, queue_size,
+                                                      kind);
+    }
+    seek_probe &m_probe;
+};
+
+struct null_audio_renderer : renderers::i_audio_renderer {
+    void push_frame(std::shared_ptr<media_sample>) override {}
+    void render() override {}
+    void pause() override {}
+    void resume() override {}
+    void stop() override {}
+    void flush() override {}
+    queue_stats get_queue_stats() const override { return {}; }
+    std::optional<int64_t> get_next_frame_due_ms() const override {
+        return std::nullopt;
+    }
+    latency_stats get_queue_latency() const override { return {}; }
+    audio_render_counters get_render_counters() const override { return {}; }
+};
+
+struct null_audio_renderer_factory : renderers::i_audio_renderer_factory {
+    std::unique_ptr<renderers::i_audio_renderer>
+    create_audio_renderer(renderers::media_clock &, size_t,
+                          queue_kind) override {
+        return std::make_unique<null_audio_renderer>();
+    }
+};
+
+// Turns the probe's requests into commands on the render thread
+struct probe_input_handler : input::i_input_handler {
+    explicit probe_input_handler(seek_probe &probe) : m_probe{probe} {}
+    void poll() override {
+        if (m_probe.quit) {
+            m_callback(input::command::quit);
+        } else if (m_probe.target_ms >= 0) {
+            m_callback(input::command::seek_forward);
+        }
+    }
+    void set_command_callback(input::command_callback callback) override {
+        m_callback = std::move(callback);
+    }
+    seek_probe &m_probe;
+    input::command_callback m_callback;
+};
+
+struct probe_input_handler_factory : input::i_input_handler_factory {
+    explicit probe_input_handler_factory(seek_probe &probe) : m_probe{probe} {}
+    std::unique_ptr<input::i_input_handler> create() override {
+        return std::make_unique<probe_input_handler>(m_probe);
+    }
+    seek_probe &m_probe;
+};
+} // namespace
+
+/**
+ * @brief Time from seek() to the first frame of the new position reaching
+ * the video renderer
+ *
+ * range(0): seek_mode (0 = keyframe, 1 = accurate)
+ * range(1): target offset into its GOP, in frames
+ *
+ * Targets walk across the stream in both directions. Accurate seeks decode
+ * and discard the frames between the keyframe and the target, so their
+ * latency grows with the offset; keyframe seeks do not.
+ */
+static void BM_SeekLatency(benchmark::State &state) {
+    const auto mode = static_cast<seek_mode>(state.range(0));
+    const int64_t gop_offset = state.range(1);
+
+    seek_probe probe;
+    media_pipeline pipeline{
+        std::make_unique<null_source_factory>(),
+        std::make_unique<synthetic_extractor_factory>(probe),
+        std::make_unique<synthetic_decoder_factory>(),
+        std::make_unique<probe_video_renderer_factory>(probe),
+        std::make_unique<null_audio_renderer_factory>(),
+        std::make_unique<probe_input_handler_factory>(probe)};
+
+    pipeline.set_command_callback([&](input::command cmd) {
+        if (cmd == input::command::quit) {
+            pipeline.stop();
+            return;
+        }
+        const auto target = probe.target_ms.exchange(-1);
+        probe.measured_generation = probe.generation + 1;
+        probe.recorded = false;
+        probe.requested = std::chrono::steady_clock::now();
+        pipeline.seek(target, mode);
+    });
+    pipeline.load("synthetic://seek");
+
+    std::jthread render_thread([&pipeline] { pipeline.play(); });
+
+    constexpr int64_t kGops = kStreamFrames / kGopFrames;
+    int64_t gop = 0;
+    for (auto _ : state) {
+        // Alternate far forward and backward jumps
+        gop = (gop + kGops / 2 + 1) % (kGops - 1);
+        const int64_t target_frame = gop * kGopFrames + gop_offset;
+
+        probe.first_frame_pts = -1;
+        probe.target_ms = frame_pts_ms(target_frame);
+        probe.first_frame_pts.wait(-1);
+
+        state.SetIterationTime(
+            std::chrono::duration<double>(probe.first_frame - probe.requested)
+                .count());
+    }
+
+    probe.quit = true;
+    render_thread.join();
+}
+BENCHMARK(BM_SeekLatency)
+    ->ArgNames({"accurate", "gop_offset"})
+    ->Args({0, 15})
+    ->Args({1, 0})
+    ->Args({1, 15})
+    ->Args({1, 29})
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
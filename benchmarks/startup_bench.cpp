@@ -0,0 +1,199 @@
+/**
+ * @file startup_bench.cpp
+ * @brief Startup latency of an HTTP source over a slow link
+ *
+ * A 20-second MP4 is synthesized once with FFmpeg's MPEG-4 encoder and mp4
+ * muxer, either with the moov atom at the end (what a plain muxer writes) or
+ * moved to the front. The loopback HTTP server serves it with a response
+ * delay and a per-connection rate limit. Each iteration does what
+ * media_pipeline::load() does before the first packet: open the media source
+ * and start the extractor. The time is how long a player waits before it can
+ * decode anything.
+ */
+
+#include "data_sources/loopback_http_server.hpp"
+#include "yapl/detail/ffmpeg_media_extractor.hpp"
+#include "yapl/detail/media_source.hpp"
+#include "yapl/pipeline_config.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/dict.h>
+}
+
+using namespace yapl;
+
+namespace {
+constexpr int kWidth = 640;
+constexpr int kHeight = 360;
+constexpr int kFps = 30;
+constexpr int kSeconds = 20;
+constexpr int64_t kBitRate = 2'000'000;
+
+// A slow, distant server: 40ms to answer, 2MB/s per connection
+constexpr auto kResponseDelay = std::chrono::milliseconds(40);
+constexpr size_t kRateLimit = 2 * 1024 * 1024;
+
+// Encodes kSeconds of noise-textured video into an mp4 file and returns its
+// bytes. Noise keeps the encoder at kBitRate, so the file has a realistic
+// size for its duration.
+std::optional<std::vector<uint8_t>> encode_mp4(bool moov_first) {
+    const auto path = std::filesystem::temp_directory_path() /
+                      (moov_first ? "yapl_startup_front.mp4"
+                                  : "yapl_startup_end.mp4");
+    const AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    AVFormatContext *oc = nullptr;
+    if (!codec || avformat_alloc_output_context2(&oc, nullptr, "mp4",
+                                                 path.c_str()) < 0) {
+        return std::nullopt;
+    }
+    AVStream *stream = avformat_new_stream(oc, nullptr);
+
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    ctx->width = kWidth;
+    ctx->height = kHeight;
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx->time_base = {1, kFps};
+    ctx->framerate = {kFps, 1};
+    ctx->gop_size = kFps;
+    ctx->bit_rate = kBitRate;
+    if (oc->oformat->flags & AVFMT_GLOBALHEADER) {
+        ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    AVDictionary *options = nullptr;
+    if (moov_first) {
+        av_dict_set(&options, "movflags", "faststart", 0);
+    }
+    stream->time_base = ctx->time_base;
+    if (avcodec_open2(ctx, codec, nullptr) < 0 ||
+        avcodec_parameters_from_context(stream->codecpar, ctx) < 0 ||
+        avio_open(&oc->pb, path.c_str(), AVIO_FLAG_WRITE) < 0 ||
+        avformat_write_header(oc, &options) < 0) {
+        av_dict_free(&options);
+        avcodec_free_context(&ctx);
+        avformat_free_context(oc);
+        return std::nullopt;
+    }
+    av_dict_free(&options);
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = ctx->pix_fmt;
+    frame->width = ctx->width;
+    frame->height = ctx->height;
+    av_frame_get_buffer(frame, 0);
+    AVPacket *pkt = av_packet_alloc();
+
+    const auto write_packets = [&] {
+        while (avcodec_receive_packet(ctx, pkt) == 0) {
+            av_packet_rescale_ts(pkt, ctx->time_base, stream->time_base);
+            pkt->stream_index = stream->index;
+            av_interleaved_write_frame(oc, pkt);
+        }
+    };
+
+    uint32_t seed = 1;
+    for (int i = 0; i < kFps * kSeconds; ++i) {
+        av_frame_make_writable(frame);
+        for (int plane = 0; plane < 3; ++plane) {
+            const int rows = plane == 0 ? kHeight : kHeight / 2;
+            const int cols = plane == 0 ? kWidth : kWidth / 2;
+            for (int y = 0; y < rows; ++y) {
+                for (int x = 0; x < cols; ++x) {
+                    seed = seed * 1664525 + 1013904223;
+                    frame->data[plane][y * frame->linesize[plane] + x] =
+                        static_cast<uint8_t>(x + y + i + (seed >> 28));
+                }
+            }
+        }
+        frame->pts = i;
+        avcodec_send_frame(ctx, frame);
+        write_packets();
+    }
+    avcodec_send_frame(ctx, nullptr);
+    write_packets();
+    av_write_trailer(oc);
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+    avio_closep(&oc->pb);
+    avformat_free_context(oc);
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                               std::istreambuf_iterator<char>());
+    in.close();
+    std::filesystem::remove(path);
+    return bytes;
+}
+
+const std::optional<std::vector<uint8_t>> &mp4_file(bool moov_first) {
+    static const auto moov_at_end = encode_mp4(false);
+    static const auto moov_at_front = encode_mp4(true);
+    return moov_first ? moov_at_front : moov_at_end;
+}
+} // namespace
+
+/**
+ * @brief media_source::open() plus ffmpeg_media_extractor::start() over
+ * throttled HTTP
+ *
+ * range(0): moov atom position (0 = end of file, 1 = front)
+ * range(1): startup mode (0 = defaults: 512KB HTTP buffer and FFmpeg's 5MB /
+ *           5s probe limits, 1 = extractor_config::fast_start)
+ */
+static void BM_StartupLatency(benchmark::State &state) {
+    const bool moov_first = state.range(0) != 0;
+    const bool fast_start = state.range(1) != 0;
+    const auto &file = mp4_file(moov_first);
+    if (!file || file->empty()) {
+        state.SkipWithError("FFmpeg build has no usable MPEG-4 encoder");
+        return;
+    }
+
+    data_sources::test::loopback_http_server server(*file);
+    server.set_response_delay(kResponseDelay);
+    server.set_rate_limit(kRateLimit);
+
+    // Same mapping media_pipeline applies for fast start
+    const extractor_config extractor_settings{.fast_start = fast_start};
+    const source_config source_settings{
+        .http_buffer_min_kb = fast_start ? 0u : 512u};
+
+    for (auto _ : state) {
+        const size_t requests_before = server.request_count();
+        const auto start = std::chrono::steady_clock::now();
+
+        auto source = std::make_shared<media_source>(source_settings);
+        source->open(server.url());
+        ffmpeg_media_extractor extractor{source, extractor_settings};
+        extractor.start();
+
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        state.SetIterationTime(elapsed.count());
+        state.counters["requests"] = static_cast<double>(
+            server.request_count() - requests_before);
+    }
+
+    state.counters["file_kb"] = static_cast<double>(file->size() / 1024);
+}
+BENCHMARK(BM_StartupLatency)
+    ->ArgNames({"moov_first", "fast"})
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->UseManualTime()
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond);
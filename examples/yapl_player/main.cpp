@@ -5,8 +5,14 @@
 #include <yapl/renderers/sdl/audio_renderer_factory.hpp>
 #include <yapl/renderers/sdl/video_renderer_factory.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 
+namespace {
+constexpr int64_t kSeekStepMs = 10000;
+} // namespace
+
 int main(int argc, char **argv) {
     if (argc < 2) {
         LOG_ERROR("Usage: {} <media_file_or_url>", argv[0]);
@@ -38,12 +44,19 @@ int main(int argc, char **argv) {
         case yapl::input::command::quit:
             player.stop();
             break;
-        case yapl::input::command::seek_forward:
-            LOG_WARN("Seek forward not implemented");
-            break;
-        case yapl::input::command::seek_backward:
-            LOG_WARN("Seek backward not implemented");
-            break;
+        case yapl::input::command::seek_forward: {
+            const auto progress = player.get_stats().progress;
+            auto target = progress.position_ms + kSeekStepMs;
+            if (progress.duration_ms > 0) {
+                target = std::min(target, progress.duration_ms);
+            }
+            player.seek(target);
+        } break;
+        case yapl::input::command::seek_backward: {
+            const auto progress = player.get_stats().progress;
+            player.seek(
+                std::max<int64_t>(progress.position_ms - kSeekStepMs, 0));
+        } break;
         case yapl::input::command::volume_up:
             LOG_WARN("Volume up not implemented");
             break;
@@ -60,7 +73,8 @@ int main(int argc, char **argv) {
 
     // Load and play
     player.load(argv[1]);
-    LOG_INFO("Controls: SPACE=Pause, S=Stats, Q/ESC=Quit");
+    LOG_INFO("Controls: SPACE=Pause, LEFT/RIGHT=Seek 10s, S=Stats, "
+             "Q/ESC=Quit");
     player.play();
 
     return 0;
@@ -9,9 +9,10 @@ namespace yapl::decoders::ffmpeg {
 struct ffmpeg_decoder_factory : i_decoder_factory {
     std::unique_ptr<i_decoder> create_video_decoder(
         size_t codec_id,
-        std::span<uint8_t> extra_data) override {
+        std::span<uint8_t> extra_data,
+        const decoder_threading &threading) override {
         return std::make_unique<video_decoder>(
-            static_cast<AVCodecID>(codec_id), extra_data);
+            static_cast<AVCodecID>(codec_id), extra_data, threading);
     }
 
     std::unique_ptr<i_decoder> create_audio_decoder(
@@ -2,15 +2,27 @@
 
 #include "yapl/media_sample.hpp"
 #include "yapl/track_info.hpp"
+#include <functional>
 #include <memory>
 
 namespace yapl::decoders {
 
+// Receives each decoded frame; pts/dts/duration are in milliseconds
+using frame_callback = std::function<void(std::shared_ptr<media_sample>)>;
+
 struct i_decoder {
     virtual ~i_decoder() = default;
+    // Feeds one packet and emits every frame the codec has ready, which may be
+    // none (decoder delay) or several. Returns false on errors
     virtual bool decode(std::shared_ptr<track_info> info,
                         std::shared_ptr<media_sample> sample,
-                        std::shared_ptr<media_sample> decoded_sample) = 0;
+                        const frame_callback &on_frame) = 0;
+    // Drains frames still buffered in the codec (e.g. B-frame delay) at end
+    // of stream and resets it so decoding can start over
+    virtual bool flush(const frame_callback &on_frame) = 0;
+    // Discards everything buffered in the codec without emitting it, e.g.
+    // before decoding from a new position after a seek
+    virtual void reset() = 0;
 };
 
 } // namespace yapl::decoders
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "yapl/decoders/i_decoder.hpp"
+#include "yapl/pipeline_config.hpp"
 #include "yapl/track_info.hpp"
 #include <memory>
 #include <span>
@@ -12,7 +13,8 @@ struct i_decoder_factory {
 
     virtual std::unique_ptr<i_decoder> create_video_decoder(
         size_t codec_id,
-        std::span<uint8_t> extra_data) = 0;
+        std::span<uint8_t> extra_data,
+        const decoder_threading &threading) = 0;
 
     virtual std::unique_ptr<i_decoder> create_audio_decoder(
         size_t codec_id,
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace yapl {
+
+/**
+ * @brief AVCC (length-prefixed) to Annex-B (start-code) conversion
+ *
+ * Applies to H.264 and HEVC alike (ISO 14496-15 sample format). An AVCC
+ * access unit is a sequence of NAL units, each preceded by a
+ * big-endian length of nal_length_size (1, 2 or 4) bytes. Annex-B replaces
+ * every prefix with the 4-byte start code 00 00 00 01. Bytes after the last
+ * complete NAL unit (fewer than nal_length_size) are dropped.
+ */
+
+// Size of the Annex-B form in one pass over the length prefixes; nullopt if
+// a NAL unit runs past the end of the packet or nal_length_size is not 1-4
+[[nodiscard]] std::optional<size_t>
+avcc_to_annexb_size(std::span<const uint8_t> avcc, size_t nal_length_size);
+
+// Writes the Annex-B form of avcc into out, which must be exactly
+// avcc_to_annexb_size() bytes
+void avcc_to_annexb(std::span<const uint8_t> avcc, size_t nal_length_size,
+                    std::span<uint8_t> out);
+
+// 4-byte lengths only: start codes are the same size as the prefixes, so
+// they are overwritten in place. Returns the converted size (the caller
+// trims anything after it), or nullopt if the packet is malformed, in which
+// case data is left partially converted.
+[[nodiscard]] std::optional<size_t>
+avcc_to_annexb_in_place(std::span<uint8_t> data);
+
+} // namespace yapl
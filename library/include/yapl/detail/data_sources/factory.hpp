@@ -2,6 +2,7 @@
 
 #include "yapl/detail/data_sources/file.hpp"
 #include "yapl/detail/data_sources/http.hpp"
+#include "yapl/detail/data_sources/mapped_file.hpp"
 
 #include <memory>
 #include <string_view>
@@ -28,16 +29,29 @@ constexpr bool is_http_url(std::string_view url) noexcept {
     return starts_with_icase(url, "http://") || starts_with_icase(url, "https://");
 }
 
+// Local file to read through a memory mapping: file+mmap:///path/to/file
+inline constexpr std::string_view kMappedFileScheme = "file+mmap://";
+
+constexpr bool is_mapped_file_url(std::string_view url) noexcept {
+    return starts_with_icase(url, kMappedFileScheme);
+}
+
 // Variant type for polymorphic data sources with static dispatch
 using data_source_variant = std::variant<
     std::unique_ptr<file>,
-    std::unique_ptr<http>
+    std::unique_ptr<http>,
+    std::unique_ptr<mapped_file>
 >;
 
 // Factory function to create appropriate data source based on URL
-inline data_source_variant create(std::string_view url) {
+inline data_source_variant create(std::string_view url,
+                                  const source_config& config = {}) {
     if (is_http_url(url)) {
-        return std::make_unique<http>(std::string(url));
+        return std::make_unique<http>(std::string(url), config);
+    }
+    if (is_mapped_file_url(url)) {
+        return std::make_unique<mapped_file>(
+            std::filesystem::path(url.substr(kMappedFileScheme.size())));
     }
     return std::make_unique<file>(std::filesystem::path(url));
 }
@@ -23,6 +23,8 @@ class file {
     size_t read_data(size_t size, std::span<uint8_t> buffer);
     [[nodiscard]] size_t available() const;
     void reset();
+    bool seek(size_t offset);
+    [[nodiscard]] std::optional<size_t> size() const;
 
   private:
     std::filesystem::path m_file_path;
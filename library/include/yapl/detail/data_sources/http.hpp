@@ -1,21 +1,45 @@
 #pragma once
 
 #include "yapl/i_data_source.hpp"
+#include "yapl/pipeline_config.hpp"
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
 
 typedef void CURL;
+typedef void CURLM;
 
 namespace yapl::data_sources {
 
+/**
+ * @brief HTTP(S) resource downloaded on a background thread
+ *
+ * Downloaded bytes go into a fixed-capacity ring. When the ring is full the
+ * transfer is paused and resumed once the reader has drained enough of it,
+ * so memory stays bounded however long the stream is. Up to
+ * http_back_buffer_size bytes behind the read position are kept for short
+ * backward seeks.
+ *
+ * With http_connections above 1 the bytes ahead are fetched as
+ * http_segment_size Range requests over that many concurrent connections,
+ * each writing straight into its reserved part of the ring. Servers that
+ * ignore Range fall back to a single sequential transfer.
+ */
 class http {
   public:
-    explicit http(std::string url);
+    // Largest chunk curl hands to the write callback; the ring always keeps
+    // room for two of them next to the back-buffer
+    static constexpr size_t kTransferChunkSize = 256 * 1024;
+
+    explicit http(std::string url, const source_config &config = {});
     ~http();
 
     http(const http &) = delete;
@@ -29,25 +53,96 @@ class http {
     size_t read_data(size_t size, std::span<uint8_t> buffer);
     [[nodiscard]] size_t available() const;
     void reset();
+    // Offsets still in the ring are served from memory; others restart the
+    // transfer there with a Range request, if the server accepts ranges
+    bool seek(size_t offset);
+    [[nodiscard]] std::optional<size_t> size() const;
 
     [[nodiscard]] std::string get_url() const { return m_url; }
     [[nodiscard]] size_t get_content_length() const { return m_content_length; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
 
   private:
+    // Request end of a transfer that runs to the end of the resource
+    static constexpr size_t kOpenEnded = SIZE_MAX;
+
+    // One request on the multi handle. Only the download thread touches
+    // it; written is read by commit() under m_buffer_mutex.
+    struct transfer {
+        http *owner;
+        CURL *handle;
+        size_t begin;
+        // One past the last requested byte, or kOpenEnded
+        size_t end;
+        // Resource offset of the next byte the server sends
+        size_t written;
+        // Status code of the last response header block
+        long status{0};
+        bool done{false};
+    };
+
     static size_t write_callback(char *ptr, size_t size, size_t nmemb,
                                  void *userdata);
     static size_t header_callback(char *buffer, size_t size, size_t nitems,
                                   void *userdata);
     void download_thread_func();
+    // Downloads from offset on the background thread
+    void start_transfer(size_t offset);
+    // Aborts the running transfers and joins the download thread
+    void stop_transfer();
+    // Adds requests until the connection limit, the ring or the resource
+    // runs out. Download thread only.
+    void schedule_transfers();
+    void add_transfer(size_t begin, size_t end);
+    // Returns false and records the error if the transfer failed
+    bool finish_transfer(CURL *handle, int result);
+    // Advances m_write_offset over the contiguous data written by the
+    // oldest transfers and drops the finished ones. Requires m_buffer_mutex.
+    void commit();
+    // Drops read bytes beyond the back-buffer and resumes a paused transfer
+    // once a chunk fits again. Requires m_buffer_mutex.
+    void release_consumed();
+    [[nodiscard]] size_t free_space() const;
 
     std::string m_url;
+    size_t m_capacity;
+    size_t m_back_buffer_size;
+    size_t m_connections;
+    size_t m_segment_size;
+    // Bytes open() waits for after the response headers
+    size_t m_min_buffer_size;
+    // Holds the options every transfer handle is duplicated from
     CURL *m_curl_handle{nullptr};
+    CURLM *m_multi_handle{nullptr};
     bool m_is_open{false};
 
-    // Internal buffer for downloaded data
+    // Download thread state, ordered by begin
+    std::deque<std::unique_ptr<transfer>> m_transfers;
+    // Finished handles kept for reuse
+    std::vector<CURL *> m_idle_handles;
+    // Next offset to request, kOpenEnded once a transfer runs to the end
+    size_t m_next_offset{0};
+    // Whether a response has shown if the server honors Range
+    bool m_probed{false};
+
+    // Ring of downloaded data. Offsets are absolute positions in the
+    // resource; byte n lives at m_buffer[n % m_capacity] while
+    // m_buffer_offset <= n < m_write_offset.
     std::vector<uint8_t> m_buffer;
-    size_t m_read_position{0};
-    size_t m_content_length{0};
+    size_t m_buffer_offset{0};
+    size_t m_write_offset{0};
+    size_t m_read_offset{0};
+    // End of the ring space promised to transfers in flight
+    size_t m_reserved_until{0};
+    // Set when the ring has no room for the next chunk or request
+    bool m_paused{false};
+    std::atomic_bool m_resume_requested{false};
+    // Total resource size, 0 while unknown. Both are written by the
+    // download thread while parsing headers.
+    std::atomic<size_t> m_content_length{0};
+    std::atomic_bool m_accepts_ranges{false};
+    // Set under m_buffer_mutex once the final response's headers are in
+    bool m_headers_received{false};
     mutable std::mutex m_buffer_mutex;
     std::condition_variable m_data_available_cv;
 
@@ -57,9 +152,6 @@ class http {
     std::atomic_bool m_stop_requested{false};
     std::atomic_bool m_download_error{false};
     std::string m_error_message;
-
-    static constexpr size_t kMinBufferBeforeRead =
-        512 * 1024; // 512KB minimum before allowing reads
 };
 
 // Static assertion to verify http satisfies data_source concept
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "yapl/i_data_source.hpp"
+
+#include <filesystem>
+
+namespace yapl::data_sources {
+
+/**
+ * @brief Local file read through a read-only memory mapping
+ *
+ * read_data() is a memcpy out of the page cache instead of a read syscall
+ * per call. The kernel is told the file is read sequentially, and the window
+ * ahead of the read position is prefetched as reading advances.
+ *
+ * mapping() and consume() give direct access to the mapped bytes for
+ * callers that can work without a copy. Spans stay valid until close().
+ */
+class mapped_file {
+  public:
+    // Bytes prefetched ahead of the read position
+    static constexpr size_t kReadAheadBytes = 8 * 1024 * 1024;
+
+    explicit mapped_file(std::filesystem::path file_path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+    mapped_file(mapped_file &&other) noexcept;
+    mapped_file &operator=(mapped_file &&other) noexcept;
+
+    void open();
+    void close();
+    [[nodiscard]] bool is_open() const;
+    size_t read_data(size_t size, std::span<uint8_t> buffer);
+    [[nodiscard]] size_t available() const;
+    void reset();
+    bool seek(size_t offset);
+    [[nodiscard]] std::optional<size_t> size() const;
+
+    // The whole file
+    [[nodiscard]] std::span<const uint8_t> mapping() const;
+    // Up to size bytes from the read position, which advances past them
+    std::span<const uint8_t> consume(size_t size);
+
+  private:
+    // Prefetches the next window once reading gets close to its end
+    void read_ahead();
+    void unmap();
+
+    std::filesystem::path m_file_path;
+    const uint8_t *m_data{nullptr};
+    size_t m_size{0};
+    size_t m_position{0};
+    size_t m_prefetched_until{0};
+    bool m_is_open{false};
+};
+
+static_assert(data_source<mapped_file>,
+              "mapped_file must satisfy data_source concept");
+
+} // namespace yapl::data_sources
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "yapl/decoders/i_decoder.hpp"
+#include "yapl/detail/frame_pool.hpp"
 #include "yapl/media_sample.hpp"
 #include "yapl/track_info.hpp"
 
@@ -25,11 +26,21 @@ struct audio_decoder : public i_decoder {
 
     bool decode(std::shared_ptr<track_info> info,
                 std::shared_ptr<media_sample> sample,
-                std::shared_ptr<media_sample> decoded_sample) override;
+                const frame_callback &on_frame) override;
+    bool flush(const frame_callback &on_frame) override;
+    void reset() override;
 
   private:
+    // Emits every frame the codec has ready
+    bool receive_frames(const frame_callback &on_frame);
+
     AVCodecParameters *m_codecpar;
     AVCodecContext *m_codec_ctx;
+    // Reused for every decode() call
+    AVPacket *m_packet;
+    AVFrame *m_frame;
+    // Output samples return here once the renderer releases them
+    frame_pool m_frame_pool;
 };
 
 } // namespace yapl::decoders::ffmpeg
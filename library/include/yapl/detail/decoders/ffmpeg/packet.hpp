@@ -0,0 +1,23 @@
+#pragma once
+
+#include "yapl/media_sample.hpp"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <libavcodec/packet.h>
+#ifdef __cplusplus
+}
+#endif
+
+namespace yapl::decoders::ffmpeg {
+
+// Points a blank packet at the sample's compressed bytes and timestamps.
+// A referenced payload (media_sample::packet) is sent with a new reference
+// to its libavutil buffer, or else wrapped in an AVBufferRef that holds its
+// owner, so libavcodec keeps a reference instead of copying; a data vector
+// is sent unowned and libavcodec copies it. Returns false if
+// the sample carries no bytes. Release with av_packet_unref() after sending.
+bool load_packet(const media_sample &sample, AVPacket *packet);
+
+} // namespace yapl::decoders::ffmpeg
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "yapl/decoders/i_decoder.hpp"
+#include "yapl/detail/frame_pool.hpp"
 #include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
 #include "yapl/track_info.hpp"
 
 #ifdef __cplusplus
@@ -11,6 +13,7 @@ extern "C" {
 #include <libavcodec/codec.h>
 #include <libavcodec/codec_id.h>
 #include <libavcodec/codec_par.h>
+#include <libswscale/swscale.h>
 #ifdef __cplusplus
 }
 #endif
@@ -20,16 +23,34 @@ extern "C" {
 namespace yapl::decoders::ffmpeg {
 
 struct video_decoder : public i_decoder {
-    video_decoder(AVCodecID codec_id, std::span<uint8_t> extra_data);
+    video_decoder(AVCodecID codec_id, std::span<uint8_t> extra_data,
+                  const decoder_threading &threading = {});
     ~video_decoder() override;
 
     bool decode(std::shared_ptr<track_info> info,
                 std::shared_ptr<media_sample> sample,
-                std::shared_ptr<media_sample> decoded_sample) override;
+                const frame_callback &on_frame) override;
+    bool flush(const frame_callback &on_frame) override;
+    void reset() override;
 
   private:
+    // Emits every frame the codec has ready
+    bool receive_frames(const frame_callback &on_frame);
+    // Converts a frame the renderers cannot show (10-bit, 4:2:2, ...) into
+    // m_converted; nullptr if swscale cannot
+    AVFrame *convert_to_yuv420p(const AVFrame *frame);
+
     AVCodecParameters *m_codecpar;
     AVCodecContext *m_codec_ctx;
+    // Reused for every decode() call
+    AVPacket *m_packet;
+    AVFrame *m_frame;
+    // Output of convert_to_yuv420p()
+    AVFrame *m_converted;
+    SwsContext *m_sws_ctx{nullptr};
+    int m_converted_from{AV_PIX_FMT_NONE};
+    // Output samples return here once the renderer releases them
+    frame_pool m_frame_pool;
 };
 
 } // namespace yapl::decoders::ffmpeg
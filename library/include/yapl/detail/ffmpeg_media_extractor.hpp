@@ -4,7 +4,12 @@
 #include "yapl/i_media_source.hpp"
 #include "yapl/media_info.hpp"
 #include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -19,7 +24,8 @@ struct ffmpeg_media_extractor : public i_media_extractor {
     enum class packet_format { unknown, annexb, avcc, raw_nal_payload };
 
   public:
-    ffmpeg_media_extractor(std::shared_ptr<i_media_source> mediaSource);
+    ffmpeg_media_extractor(std::shared_ptr<i_media_source> mediaSource,
+                           const extractor_config &config = {});
 
     ~ffmpeg_media_extractor();
 
@@ -29,22 +35,48 @@ struct ffmpeg_media_extractor : public i_media_extractor {
 
     read_sample_result read_sample() override;
 
-  private:
-    size_t get_nal_header_len() const;
+    bool seek(int64_t position_ms) override;
+
+    keyframe_index get_keyframe_index(size_t track_id) const override;
+
+    extractor_startup_stats get_startup_stats() const override;
 
+  private:
     void fetch_media_info();
 
-    static packet_format determine_packet_format(size_t nal_size_len,
-                                                 const std::span<uint8_t>);
+    // Copies the keyframes of the stream's container index, if it has one
+    void seed_keyframe_index(size_t stream_id);
+
+    // Byte seek to a keyframe recorded during playback; false if the index
+    // cannot place position_ms in a GOP
+    bool seek_indexed_keyframe(int64_t position_ms);
+
+    static packet_format determine_packet_format(
+        size_t nal_size_len, std::span<const uint8_t> packet);
 
-    static void packet_to_annexb(size_t nal_size_length, AVPacket &pkt,
-                                 std::shared_ptr<media_sample> &sample);
+    static void packet_to_annexb(size_t nal_size_length,
+                                 std::span<const uint8_t> packet,
+                                 media_sample &sample);
 
   private:
     std::shared_ptr<i_media_source> m_media_source;
 
     std::shared_ptr<media_info> m_media_info;
 
+    const video_bitstream m_bitstream;
+
+    // AVCC length prefix size per stream index when converting to Annex-B;
+    // 0 forwards the stream's packets untouched
+    std::vector<uint8_t> m_nal_length_sizes;
+
+    // Per stream index; only video streams are filled. Guarded so the
+    // indexes can be read while the buffering thread demuxes.
+    std::vector<keyframe_index> m_keyframe_indexes;
+    mutable std::mutex m_keyframe_mutex;
+
+    // First video stream, which seeks are placed by; -1 without video
+    int m_video_stream{-1};
+
     AVPacket m_pkt;
 
     AVFormatContext *m_fmt_ctx;
@@ -52,6 +84,8 @@ struct ffmpeg_media_extractor : public i_media_extractor {
     uint8_t *m_avio_buffer;
 
     AVIOContext *m_avio_ctx;
+
+    extractor_startup_stats m_startup_stats;
 };
 
 } // namespace yapl
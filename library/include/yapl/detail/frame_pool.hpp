@@ -0,0 +1,73 @@
+#pragma once
+
+#include "yapl/media_sample.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace yapl {
+
+enum class sample_format { unknown, yuv420p, f32_interleaved };
+
+/**
+ * @brief Identifies interchangeable decoded buffers
+ *
+ * For video, width/height are the picture dimensions. For audio, width is the
+ * channel count and height the sample rate.
+ */
+struct frame_key {
+    sample_format format{sample_format::unknown};
+    size_t width{0};
+    size_t height{0};
+
+    bool operator==(const frame_key &) const = default;
+};
+
+struct frame_pool_stats {
+    size_t allocations{0}; // Frames created because the free list was empty
+    size_t reuses{0};      // Frames handed out from the free list
+    size_t free_frames{0}; // Frames currently waiting in the free list
+};
+
+/**
+ * @brief Recycles decoded media_sample objects and their buffers
+ *
+ * acquire() hands out a shared_ptr whose deleter returns the sample, with its
+ * data vector still sized, to the pool once the last reference (usually the
+ * renderer's) is dropped. The shared_ptr control blocks are recycled as well,
+ * and so is a plane owner that provides frame_planes::release, so
+ * steady-state playback performs no heap allocations of its own.
+ *
+ * The pool tracks one key at a time: acquiring with a different key (e.g. a
+ * resolution change) releases buffers of the previous key. Thread-safe;
+ * frames may outlive the pool.
+ */
+class frame_pool {
+  public:
+    static constexpr size_t kDefaultMaxFreeFrames = 128;
+
+    explicit frame_pool(size_t max_free_frames = kDefaultMaxFreeFrames);
+    ~frame_pool();
+
+    frame_pool(const frame_pool &) = delete;
+    frame_pool &operator=(const frame_pool &) = delete;
+
+    /**
+     * @brief Get a sample for the given key
+     * @param key Format of the decoded data
+     * @param size_bytes Data size to provide; 0 leaves sizing to the writer
+     *
+     * Timing fields and planes are reset. Data contents are left as they
+     * were so that recycled buffers are not zero-filled again.
+     */
+    std::shared_ptr<media_sample> acquire(const frame_key &key,
+                                          size_t size_bytes);
+
+    [[nodiscard]] frame_pool_stats stats() const;
+
+  private:
+    struct state;
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace yapl
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "yapl/pipeline_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace yapl {
+
+/**
+ * @brief Lock-free latency histogram with HDR-style log-linear buckets
+ *
+ * Every power of two is split into kSubBuckets linear buckets, so a
+ * percentile is reported within 1/kSubBuckets (~6%) of the recorded value
+ * from 1us up to kMaxValueUs. record() is a couple of relaxed atomic adds and
+ * never blocks, so any number of pipeline threads can record while another
+ * takes a snapshot.
+ */
+class latency_histogram {
+  public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    // About 19 hours; longer values are clamped
+    static constexpr size_t kMaxValueBits = 36;
+    static constexpr uint64_t kMaxValueUs =
+        (uint64_t{1} << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount =
+        (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(std::chrono::steady_clock::duration latency) noexcept {
+        using std::chrono::microseconds;
+        record_us(std::chrono::duration_cast<microseconds>(latency).count());
+    }
+
+    void record_us(int64_t value_us) noexcept {
+        const auto value = static_cast<uint64_t>(std::clamp<int64_t>(
+            value_us, 0, static_cast<int64_t>(kMaxValueUs)));
+        m_buckets[bucket_index(value)].fetch_add(1,
+                                                 std::memory_order_relaxed);
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(
+                                  max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Percentiles as the upper bound of their bucket, capped by the maximum
+    [[nodiscard]] latency_stats snapshot() const {
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        latency_stats stats;
+        stats.count = static_cast<size_t>(total);
+        if (total == 0) {
+            return stats;
+        }
+        const auto max = static_cast<int64_t>(
+            m_max.load(std::memory_order_relaxed));
+        const auto percentile = [&](uint64_t permille) {
+            // Rank of the sample at the percentile, 1-based
+            const uint64_t rank =
+                std::max<uint64_t>((total * permille + 999) / 1000, 1);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(
+                        static_cast<int64_t>(bucket_upper_bound(i)), max);
+                }
+            }
+            return max;
+        };
+        stats.p50_us = percentile(500);
+        stats.p95_us = percentile(950);
+        stats.p99_us = percentile(990);
+        stats.max_us = max;
+        return stats;
+    }
+
+    // Not atomic with respect to concurrent record() calls
+    void reset() noexcept {
+        for (auto &bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr size_t bucket_index(uint64_t value) noexcept {
+        // Values below 2 * kSubBuckets get a bucket each; above that, the
+        // top kSubBucketBits + 1 bits select the bucket
+        const size_t width = static_cast<size_t>(std::bit_width(value));
+        const size_t magnitude =
+            width > kSubBucketBits + 1 ? width - kSubBucketBits - 1 : 0;
+        return magnitude * kSubBuckets +
+               static_cast<size_t>(value >> magnitude);
+    }
+
+    static constexpr uint64_t bucket_upper_bound(size_t index) noexcept {
+        const size_t magnitude =
+            index < 2 * kSubBuckets ? 0 : index / kSubBuckets - 1;
+        const uint64_t mantissa = index - magnitude * kSubBuckets;
+        return ((mantissa + 1) << magnitude) - 1;
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace yapl
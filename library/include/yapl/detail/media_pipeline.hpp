@@ -2,6 +2,7 @@
 
 #include "yapl/decoders/i_decoder.hpp"
 #include "yapl/decoders/i_decoder_factory.hpp"
+#include "yapl/detail/latency_histogram.hpp"
 #include "yapl/i_media_extractor.hpp"
 #include "yapl/i_media_extractor_factory.hpp"
 #include "yapl/i_media_source.hpp"
@@ -16,9 +17,16 @@
 #include "yapl/renderers/i_video_renderer.hpp"
 #include "yapl/renderers/i_video_renderer_factory.hpp"
 #include "yapl/renderers/media_clock.hpp"
+#include "yapl/seek_mode.hpp"
 #include "yapl/track.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stop_token>
 #include <thread>
 
 namespace yapl {
@@ -45,19 +53,74 @@ class media_pipeline {
     void pause();
     void resume();
     void stop();
+    // Repositions playback; returns false if the extractor could not seek.
+    // Call from the thread running play() (e.g. the command callback) or
+    // while playback is not running.
+    bool seek(int64_t position_ms, seek_mode mode = seek_mode::keyframe);
+    // Seeks to the next (or previous) keyframe in the video track's keyframe
+    // index. Repeated calls fast-forward or rewind through I-frames. Returns
+    // false if the index has no keyframe that way. Same threading rules as
+    // seek().
+    bool step_keyframe(bool forward);
+    // Trick play: while enabled the video decoder thread only decodes
+    // keyframes and skips the frames in between, so each step_keyframe()
+    // costs a single I-frame decode. After it is disabled, decoding resumes
+    // at the next keyframe. Audio is unaffected. Any thread.
+    void set_keyframes_only(bool enabled);
+    [[nodiscard]] bool is_keyframes_only() const;
     [[nodiscard]] bool is_paused() const;
     [[nodiscard]] std::shared_ptr<media_info> get_media_info() const;
+    // Any thread, e.g. a monitor polling while play() runs
     [[nodiscard]] pipeline_stats get_stats() const;
     void set_command_callback(input::command_callback callback);
 
   private:
+    // Buffering and decoder threads
+    void start_workers();
+    // Stops and joins the workers; leaves tracks shut down and renderers
+    // flushed
+    void stop_workers();
+    void flush_renderers();
+    // Drops frames before the seek target and rebases the clock on the first
+    // frame that survives. Returns false for frames to drop.
+    bool accept_frame(const media_sample &frame, bool drives_clock);
+    // Blocks while paused; returns false once the thread should exit
+    bool wait_while_paused(std::stop_token st);
+    // Time until the next video frame is due, capped by kMaxRenderWait
+    [[nodiscard]] std::chrono::milliseconds next_render_wait() const;
+    // Free-running clock: moves the clock to the earliest frame due on either
+    // renderer. Returns false while a decoder has yet to deliver, or once
+    // both tracks are drained.
+    bool advance_clock();
+
     std::unique_ptr<i_media_source_factory> m_media_source_factory;
     std::unique_ptr<i_media_extractor_factory> m_media_extractor_factory;
     std::unique_ptr<decoders::i_decoder_factory> m_decoder_factory;
     pipeline_config m_config;
 
     std::atomic_bool m_running{false};
+    std::atomic<size_t> m_video_frames_decoded{0};
+    std::atomic<int64_t> m_video_decode_ns{0};
+    latency_histogram m_demux_latency;
+    latency_histogram m_decode_latency;
+    std::atomic<int64_t> m_discard_before_ms{
+        std::numeric_limits<int64_t>::min()};
+    std::atomic_bool m_rebase_on_first_frame{false};
+    std::atomic<size_t> m_frames_dropped_early{0};
+    std::atomic_bool m_keyframes_only{false};
+    // Decoder threads that drained their decoder at end of stream
+    std::atomic_bool m_video_at_eos{false};
+    std::atomic_bool m_audio_at_eos{false};
+    // Guards what get_stats() reads from other threads: the startup
+    // snapshot, the track pointers and the duration. Only load() and seek()
+    // write them, on the thread that runs play(), which reads them unlocked.
+    mutable std::mutex m_stats_mutex;
+    startup_stats m_startup;
+    std::chrono::steady_clock::time_point m_load_started;
+    int64_t m_duration_ms{0};
     std::atomic_bool m_paused{false};
+    std::mutex m_pause_mutex;
+    std::condition_variable_any m_pause_cv;
 
     renderers::media_clock m_media_clock;
     std::shared_ptr<i_media_source> m_media_source;
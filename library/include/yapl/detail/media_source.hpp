@@ -2,6 +2,7 @@
 
 #include "yapl/detail/data_sources/factory.hpp"
 #include "yapl/i_media_source.hpp"
+#include "yapl/pipeline_config.hpp"
 
 #include <memory>
 
@@ -24,7 +25,7 @@ struct raw_data_buffer {
 };
 
 struct media_source : public i_media_source {
-    media_source();
+    explicit media_source(const source_config &config = {});
 
     void open(const std::string_view url) override;
 
@@ -36,7 +37,12 @@ struct media_source : public i_media_source {
 
     void reset() override;
 
+    bool seek(size_t offset) override;
+
+    std::optional<size_t> size() const override;
+
   private:
+    source_config m_config;
     data_sources::data_source_variant m_data_source;
 };
 
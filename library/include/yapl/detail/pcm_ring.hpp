@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace yapl {
+
+/**
+ * @brief Single-producer/single-consumer byte ring for PCM audio
+ *
+ * The producer (audio decoder thread) blocks in write() while the ring is
+ * full; the consumer (the audio device callback) never blocks or takes a
+ * lock, and only wakes the producer when it is actually parked.
+ *
+ * Read and write offsets count bytes since construction and never wrap, so
+ * they double as stream positions: bytes_read() is how much audio the device
+ * has pulled.
+ */
+class pcm_ring {
+  public:
+    explicit pcm_ring(size_t capacity) : m_capacity(capacity) {
+        if (capacity == 0)
+            throw std::invalid_argument("pcm_ring requires capacity >= 1");
+        m_buffer.resize(capacity);
+    }
+
+    pcm_ring(const pcm_ring &) = delete;
+    pcm_ring &operator=(const pcm_ring &) = delete;
+
+    // Producer: copies all of data, waiting for room as needed. Returns the
+    // bytes written, which is less than data.size() only after shutdown() or
+    // when clear() discarded the ring while this call was waiting.
+    size_t write(std::span<const uint8_t> data) {
+        const auto clears = m_clears.load(std::memory_order_acquire);
+        size_t written = 0;
+        while (written < data.size()) {
+            if (m_shutdown.load(std::memory_order_acquire) ||
+                m_clears.load(std::memory_order_acquire) != clears) {
+                break;
+            }
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            const auto head = m_head.load(std::memory_order_acquire);
+            const auto free = m_capacity - static_cast<size_t>(tail - head);
+            if (free == 0) {
+                wait_for_space(head, clears);
+                continue;
+            }
+            const auto chunk = std::min(free, data.size() - written);
+            copy_in(tail, data.subspan(written, chunk));
+            m_tail.store(tail + chunk, std::memory_order_release);
+            written += chunk;
+        }
+        return written;
+    }
+
+    // Consumer: copies up to out.size() bytes without blocking. Returns the
+    // bytes copied.
+    size_t read(std::span<uint8_t> out) {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        const auto chunk =
+            std::min(static_cast<size_t>(tail - head), out.size());
+        if (chunk == 0) {
+            return 0;
+        }
+        copy_out(head, out.first(chunk));
+        m_head.store(head + chunk, std::memory_order_seq_cst);
+        if (m_parked.load(std::memory_order_seq_cst)) {
+            m_space.fetch_add(1, std::memory_order_seq_cst);
+            m_space.notify_one();
+        }
+        return chunk;
+    }
+
+    // Consumer side: discards everything buffered. A producer parked in
+    // write() is woken and drops the rest of its data rather than refilling
+    // the ring with stale audio. Must not run concurrently with read().
+    void clear() {
+        m_head.store(m_tail.load(std::memory_order_acquire),
+                     std::memory_order_seq_cst);
+        m_clears.fetch_add(1, std::memory_order_seq_cst);
+        m_space.fetch_add(1, std::memory_order_seq_cst);
+        m_space.notify_all();
+    }
+
+    // Wakes a producer blocked in write(); later writes return at once
+    void shutdown() {
+        m_shutdown.store(true, std::memory_order_seq_cst);
+        m_space.fetch_add(1, std::memory_order_seq_cst);
+        m_space.notify_all();
+    }
+
+    [[nodiscard]] bool is_shutdown() const {
+        return m_shutdown.load(std::memory_order_acquire);
+    }
+
+    // Bytes buffered
+    [[nodiscard]] size_t size() const {
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        return std::min(static_cast<size_t>(tail - head), m_capacity);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+
+    // Stream offset of the next byte write() stores
+    [[nodiscard]] uint64_t bytes_written() const {
+        return m_tail.load(std::memory_order_acquire);
+    }
+
+    // Stream offset of the next byte read() returns
+    [[nodiscard]] uint64_t bytes_read() const {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+  private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    // Parks until the consumer moves past seen_head. Publishing m_parked
+    // before re-checking pairs with read() storing m_head before checking
+    // m_parked (both seq_cst), so a wake-up cannot be missed. shutdown() and
+    // clear() bump m_space unconditionally.
+    void wait_for_space(uint64_t seen_head, uint64_t seen_clears) {
+        const auto sequence = m_space.load(std::memory_order_seq_cst);
+        m_parked.store(true, std::memory_order_seq_cst);
+        if (m_head.load(std::memory_order_seq_cst) == seen_head &&
+            !m_shutdown.load(std::memory_order_seq_cst) &&
+            m_clears.load(std::memory_order_seq_cst) == seen_clears) {
+            m_space.wait(sequence, std::memory_order_seq_cst);
+        }
+        m_parked.store(false, std::memory_order_relaxed);
+    }
+
+    void copy_in(uint64_t offset, std::span<const uint8_t> data) {
+        const auto start = static_cast<size_t>(offset % m_capacity);
+        const auto first = std::min(data.size(), m_capacity - start);
+        std::memcpy(m_buffer.data() + start, data.data(), first);
+        std::memcpy(m_buffer.data(), data.data() + first, data.size() - first);
+    }
+
+    void copy_out(uint64_t offset, std::span<uint8_t> out) const {
+        const auto start = static_cast<size_t>(offset % m_capacity);
+        const auto first = std::min(out.size(), m_capacity - start);
+        std::memcpy(out.data(), m_buffer.data() + start, first);
+        std::memcpy(out.data() + first, m_buffer.data(), out.size() - first);
+    }
+
+    std::vector<uint8_t> m_buffer;
+    const size_t m_capacity;
+
+    // Producer-owned line
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_tail{0};
+
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_head{0};
+
+    alignas(kCacheLineSize) std::atomic_bool m_shutdown{false};
+    std::atomic<uint32_t> m_space{0};
+    std::atomic_bool m_parked{false};
+    std::atomic<uint64_t> m_clears{0};
+};
+
+} // namespace yapl
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/spsc_queue.hpp"
+#include "yapl/pipeline_config.hpp"
+#include "yapl/pipeline_stats.hpp"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <variant>
+
+namespace yapl {
+
+/**
+ * @brief Queue used between pipeline stages, backed by either implementation
+ *
+ * Dispatches statically over a variant so the backing queue can be chosen per
+ * hop at runtime (see queue_kind) without virtual calls on the hot path.
+ */
+template <typename T> class pipeline_queue {
+  public:
+    using pop_result = typename blocking_queue<T>::pop_result;
+    using pop_output = typename blocking_queue<T>::pop_output;
+
+    pipeline_queue(size_t capacity, queue_kind kind)
+        : m_queue{make_queue(capacity, kind)} {}
+
+    void shutdown() {
+        visit([](auto &q) { q.shutdown(); });
+    }
+
+    bool push(const T &item) {
+        return visit([&item](auto &q) { return q.push(item); });
+    }
+
+    std::optional<T> pop() {
+        return visit([](auto &q) { return q.pop(); });
+    }
+
+    pop_output pop(std::chrono::milliseconds timeout_ms) {
+        return visit([timeout_ms](auto &q) { return q.pop(timeout_ms); });
+    }
+
+    std::optional<T> try_pop() {
+        return visit([](auto &q) { return q.try_pop(); });
+    }
+
+    bool try_push(const T &item) {
+        return visit([&item](auto &q) { return q.try_push(item); });
+    }
+
+    [[nodiscard]] size_t size() const {
+        return visit([](const auto &q) { return q.size(); });
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return visit([](const auto &q) { return q.capacity(); });
+    }
+
+    [[nodiscard]] queue_stats stats() const {
+        return visit([](const auto &q) { return q.stats(); });
+    }
+
+    bool is_empty() {
+        return visit([](auto &q) { return q.is_empty(); });
+    }
+
+    bool is_full() {
+        return visit([](auto &q) { return q.is_full(); });
+    }
+
+    bool is_shutdown() const {
+        return visit([](const auto &q) { return q.is_shutdown(); });
+    }
+
+    [[nodiscard]] queue_kind kind() const {
+        return std::holds_alternative<std::unique_ptr<spsc_queue<T>>>(m_queue)
+                   ? queue_kind::spsc
+                   : queue_kind::blocking;
+    }
+
+  private:
+    // Both queues hold atomics/mutexes and are not movable, so store by pointer
+    using queue_variant = std::variant<std::unique_ptr<blocking_queue<T>>,
+                                       std::unique_ptr<spsc_queue<T>>>;
+
+    static queue_variant make_queue(size_t capacity, queue_kind kind) {
+        if (kind == queue_kind::spsc) {
+            return std::make_unique<spsc_queue<T>>(capacity);
+        }
+        return std::make_unique<blocking_queue<T>>(capacity);
+    }
+
+    template <typename Func> auto visit(Func &&func) {
+        return std::visit([&func](auto &ptr) { return func(*ptr); }, m_queue);
+    }
+
+    template <typename Func> auto visit(Func &&func) const {
+        return std::visit([&func](const auto &ptr) { return func(*ptr); },
+                          m_queue);
+    }
+
+    queue_variant m_queue;
+};
+
+} // namespace yapl
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/pipeline_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace yapl {
+
+/**
+ * @brief Wait-free single-producer/single-consumer ring buffer
+ *
+ * Drop-in alternative to blocking_queue for hops that have exactly one
+ * producer thread and one consumer thread. try_push()/try_pop() never take a
+ * lock; the blocking push()/pop() fall back to std::atomic::wait (a futex on
+ * Linux) and only issue a wake-up when the other side is actually parked.
+ *
+ * Producer and consumer indices live on separate cache lines, and each side
+ * keeps a cached copy of the other side's index so the common case touches
+ * only its own line.
+ */
+template <typename T> class spsc_queue {
+  public:
+    using pop_result = typename blocking_queue<T>::pop_result;
+    using pop_output = typename blocking_queue<T>::pop_output;
+
+    explicit spsc_queue(size_t capacity) : m_capacity(capacity) {
+        if (capacity == 0)
+            throw std::invalid_argument("spsc_queue requires capacity >= 1");
+        m_pool.resize(capacity);
+    }
+
+    spsc_queue(const spsc_queue &) = delete;
+    spsc_queue &operator=(const spsc_queue &) = delete;
+
+    // Shutdown the queue - wakes up all blocked threads
+    void shutdown() {
+        m_shutdown.store(true, std::memory_order_seq_cst);
+        m_not_empty.signal();
+        m_not_full.signal();
+    }
+
+    // Returns false if shutdown
+    bool push(const T &item) {
+        for (uint32_t attempt = 0; !try_push(item); ++attempt) {
+            if (m_shutdown.load(std::memory_order_acquire)) return false;
+            if (backoff(attempt)) continue;
+            m_not_full.wait([this] { return !is_full() || is_shutdown(); });
+        }
+        return true;
+    }
+
+    // Returns nullopt if shutdown and empty
+    std::optional<T> pop() {
+        for (uint32_t attempt = 0;; ++attempt) {
+            if (auto item = try_pop()) return item;
+            if (m_shutdown.load(std::memory_order_acquire)) return try_pop();
+            if (backoff(attempt)) continue;
+            m_not_empty.wait([this] { return !is_empty() || is_shutdown(); });
+        }
+    }
+
+    pop_output pop(std::chrono::milliseconds timeout_ms) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout_ms;
+        for (uint32_t attempt = 0;; ++attempt) {
+            if (auto item = try_pop()) {
+                return {.result = pop_result::no_error, .data = std::move(item)};
+            }
+            if (m_shutdown.load(std::memory_order_acquire)) {
+                if (auto item = try_pop()) {
+                    return {.result = pop_result::no_error,
+                            .data = std::move(item)};
+                }
+                return {.result = pop_result::shutdown, .data = std::nullopt};
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return {.result = pop_result::timeout, .data = std::nullopt};
+            }
+            // std::atomic::wait has no timed variant, so keep backing off and
+            // then sleep in bounded slices until the deadline
+            if (backoff(attempt)) continue;
+            std::this_thread::sleep_for(
+                std::min<std::chrono::steady_clock::duration>(
+                    kMaxBackoffSleep, deadline - now));
+        }
+    }
+
+    std::optional<T> try_pop() {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail) return std::nullopt;
+        }
+        T item = std::move(m_pool[head % m_capacity]);
+        m_pool[head % m_capacity] = T{};
+        m_head.store(head + 1, std::memory_order_seq_cst);
+        m_not_full.signal();
+        return item;
+    }
+
+    bool try_push(const T &item) {
+        if (m_shutdown.load(std::memory_order_acquire)) return false;
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head == m_capacity) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head == m_capacity) return false;
+        }
+        m_pool[tail % m_capacity] = item;
+        m_tail.store(tail + 1, std::memory_order_seq_cst);
+        m_not_empty.signal();
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const {
+        // Load head first: tail only grows, so the difference never underflows.
+        // seq_cst because waiter::wait() re-checks through here
+        const auto head = m_head.load(std::memory_order_seq_cst);
+        const auto tail = m_tail.load(std::memory_order_seq_cst);
+        return std::min(static_cast<size_t>(tail - head), m_capacity);
+    }
+
+    [[nodiscard]] constexpr size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    [[nodiscard]] queue_stats stats() const {
+        return {.size = size(), .capacity = m_capacity};
+    }
+
+    bool is_empty() const { return size() == 0; }
+
+    bool is_full() const { return size() == m_capacity; }
+
+    bool is_shutdown() const {
+        return m_shutdown.load(std::memory_order_seq_cst);
+    }
+
+  private:
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr uint32_t kSpinAttempts = 64;
+    static constexpr uint32_t kYieldAttempts = 16;
+    static constexpr auto kMaxBackoffSleep = std::chrono::microseconds(500);
+
+    // Spin, then yield, before parking: the other side usually catches up
+    // within a few hundred nanoseconds and a futex round trip costs more.
+    // Returns false once the caller should block instead.
+    static bool backoff(uint32_t attempt) {
+        if (attempt < kSpinAttempts) {
+            return true;
+        }
+        if (attempt < kSpinAttempts + kYieldAttempts) {
+            std::this_thread::yield();
+            return true;
+        }
+        return false;
+    }
+
+    // Parking spot for one side of the queue. The waiter publishes that it is
+    // parked before re-checking the condition; the signaller publishes its
+    // index update before checking for waiters. Both use seq_cst, so either
+    // the waiter sees the update or the signaller sees the waiter.
+    struct alignas(kCacheLineSize) waiter {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<bool> parked{false};
+
+        template <typename Predicate> void wait(Predicate ready) {
+            const auto seen = sequence.load(std::memory_order_seq_cst);
+            parked.store(true, std::memory_order_seq_cst);
+            if (!ready()) {
+                sequence.wait(seen, std::memory_order_seq_cst);
+            }
+            parked.store(false, std::memory_order_relaxed);
+        }
+
+        void signal() {
+            if (parked.load(std::memory_order_seq_cst)) {
+                sequence.fetch_add(1, std::memory_order_seq_cst);
+                sequence.notify_one();
+            }
+        }
+    };
+
+    std::vector<T> m_pool;
+    const size_t m_capacity;
+
+    // Producer-owned line
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_tail{0};
+    uint64_t m_cached_head{0};
+
+    // Consumer-owned line
+    alignas(kCacheLineSize) std::atomic<uint64_t> m_head{0};
+    uint64_t m_cached_tail{0};
+
+    alignas(kCacheLineSize) std::atomic_bool m_shutdown{false};
+    waiter m_not_empty;
+    waiter m_not_full;
+};
+
+} // namespace yapl
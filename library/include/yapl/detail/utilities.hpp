@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 
 namespace yapl::utilities {
@@ -13,4 +15,11 @@ struct raii_cleanup {
     std::function<void()> m_cleanup;
 };
 
+// Microseconds between two steady_clock readings
+inline int64_t elapsed_us(std::chrono::steady_clock::time_point from,
+                          std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+        .count();
+}
+
 } // namespace yapl::utilities
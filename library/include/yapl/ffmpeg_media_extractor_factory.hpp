@@ -6,9 +6,11 @@
 namespace yapl {
 
 struct ffmpeg_media_extractor_factory : i_media_extractor_factory {
-    std::unique_ptr<i_media_extractor> create(
-        std::shared_ptr<i_media_source> media_source) override {
-        return std::make_unique<ffmpeg_media_extractor>(std::move(media_source));
+    std::unique_ptr<i_media_extractor>
+    create(std::shared_ptr<i_media_source> media_source,
+           const extractor_config &config) override {
+        return std::make_unique<ffmpeg_media_extractor>(std::move(media_source),
+                                                        config);
     }
 };
 
@@ -2,6 +2,7 @@
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 
 namespace yapl {
@@ -15,6 +16,8 @@ concept data_source = requires(T& t, const T& ct, size_t size, std::span<uint8_t
     { ct.available() } -> std::same_as<size_t>;
     { ct.is_open() } -> std::same_as<bool>;
     { t.reset() } -> std::same_as<void>;
+    { t.seek(size) } -> std::same_as<bool>;
+    { ct.size() } -> std::same_as<std::optional<size_t>>;
 };
 
 } // namespace yapl
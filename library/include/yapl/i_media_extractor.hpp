@@ -1,7 +1,11 @@
 #pragma once
 
+#include "yapl/keyframe_index.hpp"
 #include "yapl/media_info.hpp"
 #include "yapl/media_sample.hpp"
+#include "yapl/pipeline_stats.hpp"
+
+#include <cstdint>
 
 namespace yapl {
 
@@ -40,6 +44,37 @@ struct i_media_extractor {
      * @throws std::runtime_error if a critical read error occurs
      */
     virtual read_sample_result read_sample() = 0;
+
+    /**
+     * @brief Repositions the extractor for a seek.
+     *
+     * Lands on the nearest keyframe at or before the target, so the next
+     * read_sample() returns data a decoder can start from. Samples may still
+     * carry timestamps earlier than the target.
+     *
+     * @param position_ms Target presentation time in milliseconds
+     * @return false if the container or media source cannot seek there
+     */
+    virtual bool seek(int64_t position_ms) = 0;
+
+    /**
+     * @brief Keyframes known so far on a video track.
+     *
+     * Copied from the container index where there is one, otherwise built
+     * as read_sample() demuxes keyframes. Safe to call while another thread
+     * reads samples.
+     *
+     * @param track_id Track (stream) index from media_info
+     * @return A snapshot; empty for tracks without an index, e.g. audio
+     */
+    virtual keyframe_index get_keyframe_index(size_t track_id) const = 0;
+
+    /**
+     * @brief Time spent in the steps of the last start().
+     *
+     * @return Zeroes before start() has been called
+     */
+    virtual extractor_startup_stats get_startup_stats() const = 0;
 };
 
 } // namespace yapl
@@ -2,6 +2,7 @@
 
 #include "yapl/i_media_extractor.hpp"
 #include "yapl/i_media_source.hpp"
+#include "yapl/pipeline_config.hpp"
 #include <memory>
 
 namespace yapl {
@@ -20,12 +21,14 @@ struct i_media_extractor_factory {
      * @brief Creates a new media extractor for the given media source.
      *
      * @param media_source The media source to extract data from
+     * @param config Demuxer settings
      * @return A unique pointer to the newly created media extractor
      * @throws std::runtime_error if the extractor cannot be created or the
      *         media source is incompatible
      */
-    virtual std::unique_ptr<i_media_extractor> create(
-        std::shared_ptr<i_media_source> media_source) = 0;
+    virtual std::unique_ptr<i_media_extractor>
+    create(std::shared_ptr<i_media_source> media_source,
+           const extractor_config &config) = 0;
 };
 
 } // namespace yapl
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 
@@ -53,6 +54,22 @@ struct i_media_source {
      * @throws std::runtime_error if reset is not supported or fails
      */
     virtual void reset() = 0;
+
+    /**
+     * @brief Moves the read position to an absolute byte offset.
+     *
+     * @param offset Byte offset from the start of the media
+     * @return false if the source cannot seek or offset is past the end
+     * @throws std::runtime_error if the source is not open
+     */
+    virtual bool seek(size_t offset) = 0;
+
+    /**
+     * @brief Returns the total size of the media in bytes.
+     *
+     * @return The size, or std::nullopt if unknown (e.g. no Content-Length)
+     */
+    virtual std::optional<size_t> size() const = 0;
 };
 
 } // namespace yapl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "yapl/i_media_source.hpp"
+#include "yapl/pipeline_config.hpp"
 #include <memory>
 
 namespace yapl {
@@ -18,10 +19,12 @@ struct i_media_source_factory {
     /**
      * @brief Creates a new media source instance.
      *
+     * @param config Buffering settings for the data sources it opens
      * @return A shared pointer to the newly created media source
      * @throws std::runtime_error if the media source cannot be created
      */
-    virtual std::shared_ptr<i_media_source> create() = 0;
+    virtual std::shared_ptr<i_media_source>
+    create(const source_config &config) = 0;
 };
 
 } // namespace yapl
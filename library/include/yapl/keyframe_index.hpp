@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace yapl {
+
+/**
+ * @brief Where a keyframe starts in the stream
+ */
+struct keyframe_entry {
+    int64_t pts_ms{0};
+    // Position of the packet in the media source; -1 if unknown
+    int64_t byte_offset{-1};
+    uint32_t size{0};
+};
+
+/**
+ * @brief Keyframes of one track, sorted by presentation time
+ *
+ * Either copied from the container index when the file is opened
+ * (from_container()), or built up as keyframes are demuxed, in which case it
+ * only covers what has been read so far. Not synchronized: the extractor
+ * owns it and callers read it between read_sample() calls.
+ */
+class keyframe_index {
+  public:
+    // Inserts in pts order; an entry at an already indexed pts is ignored.
+    // Appending in playback order is O(1).
+    void add(const keyframe_entry &entry) {
+        if (m_entries.empty() || m_entries.back().pts_ms < entry.pts_ms) {
+            m_entries.push_back(entry);
+            return;
+        }
+        const auto it = lower_bound(entry.pts_ms);
+        if (it == m_entries.end() || it->pts_ms != entry.pts_ms) {
+            m_entries.insert(it, entry);
+        }
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_from_container = false;
+    }
+
+    void set_from_container(bool from_container) noexcept {
+        m_from_container = from_container;
+    }
+
+    [[nodiscard]] bool from_container() const noexcept {
+        return m_from_container;
+    }
+
+    // Keyframe starting the GOP that contains pts_ms
+    [[nodiscard]] std::optional<keyframe_entry>
+    at_or_before(int64_t pts_ms) const {
+        const auto it = upper_bound(pts_ms);
+        if (it == m_entries.begin()) {
+            return std::nullopt;
+        }
+        return *std::prev(it);
+    }
+
+    [[nodiscard]] std::optional<keyframe_entry> before(int64_t pts_ms) const {
+        const auto it = lower_bound(pts_ms);
+        if (it == m_entries.begin()) {
+            return std::nullopt;
+        }
+        return *std::prev(it);
+    }
+
+    [[nodiscard]] std::optional<keyframe_entry> after(int64_t pts_ms) const {
+        const auto it = upper_bound(pts_ms);
+        if (it == m_entries.end()) {
+            return std::nullopt;
+        }
+        return *it;
+    }
+
+    [[nodiscard]] std::span<const keyframe_entry> entries() const noexcept {
+        return m_entries;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return m_entries.size(); }
+    [[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+
+  private:
+    using iterator = std::vector<keyframe_entry>::const_iterator;
+
+    [[nodiscard]] iterator lower_bound(int64_t pts_ms) const {
+        return std::ranges::lower_bound(m_entries, pts_ms, {},
+                                        &keyframe_entry::pts_ms);
+    }
+
+    [[nodiscard]] iterator upper_bound(int64_t pts_ms) const {
+        return std::ranges::upper_bound(m_entries, pts_ms, {},
+                                        &keyframe_entry::pts_ms);
+    }
+
+    std::vector<keyframe_entry> m_entries;
+    bool m_from_container{false};
+};
+
+} // namespace yapl
@@ -1,18 +1,80 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
+// libavutil's ref-counted buffer, named here without pulling in FFmpeg
+struct AVBufferRef;
+
 namespace yapl {
 
+/**
+ * @brief Planar picture referenced in place, without copying into data
+ *
+ * owner keeps the planes alive (e.g. a ref-counted decoder AVFrame); the
+ * planes stay valid for as long as any copy of owner exists. When release is
+ * set, a recycled sample keeps owner and only calls release(owner.get()) to
+ * drop the referenced memory, so the decoder can refill the same holder for
+ * the next frame instead of allocating a new one.
+ */
+struct frame_planes {
+    static constexpr size_t kMaxPlanes = 3;
+
+    std::array<const uint8_t *, kMaxPlanes> data{};
+    std::array<int, kMaxPlanes> linesize{};
+    std::shared_ptr<void> owner;
+    void (*release)(void *owner){nullptr};
+
+    [[nodiscard]] bool empty() const { return !data[0]; }
+};
+
+/**
+ * @brief Compressed payload referenced in place, without copying into data
+ *
+ * owner keeps the bytes alive. When they live in a libavutil buffer (the
+ * FFmpeg extractor's demuxed packets), buffer is that reference, held by
+ * owner, so FFmpeg decoders can take another reference to it directly. At
+ * least kPadding readable bytes follow the payload, since decoders such as
+ * libavcodec read past the end of their input.
+ */
+struct packet_ref {
+    static constexpr size_t kPadding = 64;
+
+    const uint8_t *data{nullptr};
+    size_t size{0};
+    AVBufferRef *buffer{nullptr};
+    std::shared_ptr<void> owner;
+
+    [[nodiscard]] bool empty() const { return !owner; }
+};
+
 struct media_sample {
     size_t debug_id;
     size_t track_id;
     int64_t pts;
     int64_t dts;
     size_t duration;
+    // Compressed samples that start a GOP
+    bool keyframe{false};
     std::vector<uint8_t> data;
+    // Set instead of data by extractors that hand out demuxed buffers
+    packet_ref packet;
+    // Set instead of data by decoders that hand out their own frame memory
+    frame_planes planes;
+    // When the sample entered its current queue, for latency stats
+    std::chrono::steady_clock::time_point queued_at;
+
+    // Compressed bytes, wherever the extractor put them
+    [[nodiscard]] std::span<const uint8_t> payload() const {
+        if (!packet.empty()) {
+            return {packet.data, packet.size};
+        }
+        return data;
+    }
 };
 
 enum class read_sample_error_t {
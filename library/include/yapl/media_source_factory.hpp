@@ -6,8 +6,9 @@
 namespace yapl {
 
 struct media_source_factory : i_media_source_factory {
-    std::shared_ptr<i_media_source> create() override {
-        return std::make_shared<media_source>();
+    std::shared_ptr<i_media_source>
+    create(const source_config &config) override {
+        return std::make_shared<media_source>(config);
     }
 };
 
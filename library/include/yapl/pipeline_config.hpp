@@ -1,9 +1,128 @@
 #pragma once
 
+#include "yapl/video_bitstream.hpp"
+
 #include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace yapl {
 
+/**
+ * @brief Queue implementation used for a pipeline hop
+ *
+ * - blocking: mutex + condition variables, safe for any number of threads
+ * - spsc: wait-free single-producer/single-consumer ring with futex fallback
+ */
+enum class queue_kind { blocking, spsc };
+
+/**
+ * @brief How a decoder spreads work across threads
+ *
+ * - automatic: let the codec use whatever it supports (frame and/or slice)
+ * - frame: decode several frames in parallel; adds thread_count frames of delay
+ * - slice: decode slices of one frame in parallel; needs multi-slice streams
+ */
+enum class decoder_thread_type { automatic, frame, slice };
+
+constexpr std::string_view
+decoder_thread_type_to_string(decoder_thread_type type) noexcept {
+    switch (type) {
+        case decoder_thread_type::automatic: return "auto";
+        case decoder_thread_type::frame:     return "frame";
+        case decoder_thread_type::slice:     return "slice";
+        default:                             return "unknown";
+    }
+}
+
+/**
+ * @brief What drives the media clock
+ *
+ * - realtime: wall-clock time, for playback
+ * - audio_master: wall-clock time continuously corrected towards the audio
+ *   the device has actually played, so video follows the sound card's rate
+ *   over long sessions. Behaves like realtime without audio
+ * - free_running: jumps to the next frame as soon as the renderers are ready,
+ *   so the pipeline runs at decoder speed (batch processing, analysis). Meant
+ *   for renderers without a real-time sink such as renderers::null
+ */
+enum class clock_mode { realtime, audio_master, free_running };
+
+constexpr std::string_view clock_mode_to_string(clock_mode mode) noexcept {
+    switch (mode) {
+        case clock_mode::realtime:     return "realtime";
+        case clock_mode::audio_master: return "audio_master";
+        case clock_mode::free_running: return "free_running";
+        default:                       return "unknown";
+    }
+}
+
+/**
+ * @brief Decoder threading settings
+ */
+struct decoder_threading {
+    /** Worker threads; 0 lets the codec pick (one per logical core) */
+    size_t thread_count = 0;
+
+    /** Parallelization strategy */
+    decoder_thread_type thread_type = decoder_thread_type::automatic;
+};
+
+/**
+ * @brief Demuxer settings
+ */
+struct extractor_config {
+    /** AVIO read buffer (bytes): the size of each read from the media
+     *  source. Default: 64KB */
+    size_t io_buffer_size = 64 * 1024;
+
+    /** Most bytes read while detecting the format and probing streams;
+     *  0 keeps FFmpeg's default (5MB, or 128KB with fast_start) */
+    size_t probe_size = 0;
+
+    /** Most media time (microseconds) decoded to find stream parameters;
+     *  0 keeps FFmpeg's default (5s, or 500ms with fast_start) */
+    int64_t max_analyze_duration_us = 0;
+
+    /** Start from as little data as possible: small probe limits, and the
+     *  media source does not wait for source_config::http_buffer_min_kb.
+     *  Trades probing accuracy on odd streams for time to first frame.
+     *  Default: false */
+    bool fast_start = false;
+
+    /** Framing of video samples. passthrough forwards packets as demuxed and
+     *  the decoder takes the avcC record as extradata; annexb converts every
+     *  packet to start codes for decoders that require them.
+     *  Default: passthrough */
+    video_bitstream bitstream = video_bitstream::passthrough;
+};
+
+/**
+ * @brief Media source settings
+ */
+struct source_config {
+    /** HTTP download ring capacity (bytes). The transfer pauses while the
+     *  ring is full and resumes as the reader drains it. Default: 16MB */
+    size_t http_buffer_size = 16 * 1024 * 1024;
+
+    /** Already-read HTTP bytes kept in the ring so short backward seeks are
+     *  served without a new request (bytes). Default: 2MB */
+    size_t http_back_buffer_size = 2 * 1024 * 1024;
+
+    /** Concurrent HTTP connections. Above 1, the data ahead of the read
+     *  position is fetched as parallel Range requests, which helps on
+     *  high-latency links. Default: 1 (one sequential transfer) */
+    size_t http_connections = 1;
+
+    /** Size of each parallel Range request (bytes). Default: 1MB */
+    size_t http_segment_size = 1024 * 1024;
+
+    /** HTTP data (KB) to buffer before open() returns, once the response
+     *  headers are in. 0 returns as soon as the server has answered.
+     *  Default: 512 */
+    size_t http_buffer_min_kb = 512;
+};
+
 /**
  * @brief Configuration parameters for media pipeline
  *
@@ -20,8 +139,26 @@ struct pipeline_config {
     /** Track buffer queue capacity (encoded packets). Default: 1024 */
     size_t track_queue_size = 1024;
 
-    /** Minimum HTTP buffer (KB) before starting playback. Default: 512 */
-    size_t http_buffer_min_kb = 512;
+    /** Video renderer queue implementation. Default: spsc */
+    queue_kind video_queue_kind = queue_kind::spsc;
+
+    /** Audio renderer queue implementation. Default: spsc */
+    queue_kind audio_queue_kind = queue_kind::spsc;
+
+    /** Track buffer queue implementation. Default: spsc */
+    queue_kind track_queue_kind = queue_kind::spsc;
+
+    /** What drives the media clock. Default: realtime */
+    clock_mode playback_clock = clock_mode::realtime;
+
+    /** Video decoder threading. Default: codec picks count and type */
+    decoder_threading video_decoder_threading{};
+
+    /** Media source settings */
+    source_config source{};
+
+    /** Demuxer settings */
+    extractor_config extractor{};
 };
 
 } // namespace yapl
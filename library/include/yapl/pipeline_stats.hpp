@@ -2,7 +2,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include "yapl/pipeline_config.hpp"
+
 #include <fmt/format.h>
+#include <optional>
 #include <string>
 
 namespace yapl {
@@ -25,6 +28,8 @@ struct queue_stats {
 struct progress_info {
     int64_t position_ms{0}; // Current playback position in milliseconds
     int64_t duration_ms{0}; // Total duration in milliseconds
+    // Demuxing and decoding finished; frames may still wait in the renderers
+    bool end_of_stream{false};
 
     [[nodiscard]] constexpr float progress_percent() const noexcept {
         return duration_ms > 0
@@ -55,6 +60,152 @@ struct progress_info {
     }
 };
 
+struct decoder_stats {
+    decoder_threading threading; // Requested settings
+    size_t frames_decoded{0};    // Frames produced since load()
+    // Frames per second of time spent inside decode(): the rate the decoder
+    // sustains with these settings, independent of playback pacing
+    double decode_fps{0.0};
+
+    [[nodiscard]] std::string to_string() const {
+        const auto threads = threading.thread_count > 0
+                                 ? std::to_string(threading.thread_count)
+                                 : std::string{"auto"};
+        return fmt::format("{:.1f}fps ({} threads, {})", decode_fps, threads,
+                           decoder_thread_type_to_string(threading.thread_type));
+    }
+};
+
+// Latency distribution of one pipeline stage
+struct latency_stats {
+    size_t count{0}; // Samples recorded
+    int64_t p50_us{0};
+    int64_t p95_us{0};
+    int64_t p99_us{0};
+    int64_t max_us{0};
+
+    [[nodiscard]] std::string to_string() const {
+        if (count == 0) {
+            return "-";
+        }
+        return fmt::format("{:.1f}/{:.1f}/{:.1f}/{:.1f}ms", p50_us / 1000.0,
+                           p95_us / 1000.0, p99_us / 1000.0, max_us / 1000.0);
+    }
+};
+
+// Latency of the video renderer's steps
+struct video_render_latency {
+    latency_stats queue_wait; // Frame pushed until taken from the queue
+    latency_stats upload;     // Texture upload
+    latency_stats present;    // Clear, copy and present
+};
+
+// Per-stage latencies since load(); the renderers, which outlive a load(),
+// clear theirs on stop(). Queue waits are the time a sample or frame spends
+// queued, so a long wait points at the stage after the queue.
+struct stage_latency_stats {
+    latency_stats demux;       // i_media_extractor::read_sample()
+    latency_stats track_queue; // Video track queue
+    latency_stats decode;      // Video decode() call
+    video_render_latency video_render;
+    latency_stats audio_queue; // Audio renderer queue
+
+    // p50/p95/p99/max per stage
+    [[nodiscard]] std::string to_string() const {
+        return "demux " + demux.to_string() +
+               ", track queue " + track_queue.to_string() +
+               ", decode " + decode.to_string() +
+               ", render queue " + video_render.queue_wait.to_string() +
+               ", upload " + video_render.upload.to_string() +
+               ", present " + video_render.present.to_string() +
+               ", audio queue " + audio_queue.to_string();
+    }
+};
+
+// Video PTS on screen minus audio PTS being heard, sampled per presented
+// frame. Positive means video is ahead.
+struct drift_stats {
+    size_t samples{0};
+    int64_t last_ms{0};
+    double mean_ms{0.0};
+    int64_t max_abs_ms{0};
+
+    [[nodiscard]] std::string to_string() const {
+        if (samples == 0) {
+            return "-";
+        }
+        return fmt::format("{}ms (mean {:.1f}ms, max {}ms)", last_ms, mean_ms,
+                           max_abs_ms);
+    }
+};
+
+struct video_render_counters {
+    size_t rendered{0};     // Frames presented
+    size_t dropped_late{0}; // Frames too late for the clock
+    drift_stats av_drift;   // Sampled while audio is playing
+};
+
+struct audio_render_counters {
+    size_t rendered{0};     // Frames handed to the device
+    size_t dropped_late{0}; // Frames too late for the clock
+    size_t underruns{0};    // Times the device ran dry after being fed
+};
+
+// Playback quality counters. Cumulative over the pipeline's lifetime, so
+// monitoring can turn them into rates.
+struct playback_counters {
+    video_render_counters video;
+    audio_render_counters audio;
+    // Decoded before a seek target and discarded before reaching a renderer
+    size_t dropped_early{0};
+    // Audio-master clock: total adjustment made to follow the audio device
+    int64_t clock_correction_ms{0};
+
+    [[nodiscard]] std::string to_string() const {
+        return fmt::format("video {} shown/{} late, audio {} played/{} late/"
+                           "{} underruns, {} early, A/V drift {}, clock "
+                           "corrected {}ms",
+                           video.rendered, video.dropped_late, audio.rendered,
+                           audio.dropped_late, audio.underruns, dropped_early,
+                           video.av_drift.to_string(), clock_correction_ms);
+    }
+};
+
+// Time the extractor spent in each step of start()
+struct extractor_startup_stats {
+    int64_t open_input_us{0};       // avformat_open_input()
+    int64_t find_stream_info_us{0}; // avformat_find_stream_info()
+};
+
+// Where startup time goes, measured from the start of load()
+struct startup_stats {
+    int64_t source_open_us{0}; // i_media_source::open()
+    extractor_startup_stats extractor;
+    int64_t decoder_open_us{0}; // Creating the decoders
+    int64_t renderer_setup_us{0}; // i_video_renderer::resize()
+    int64_t load_us{0};           // All of load()
+    // Until the first video frame was presented; empty before that
+    std::optional<int64_t> time_to_first_frame_us;
+
+    [[nodiscard]] std::string to_string() const {
+        const auto ttff = time_to_first_frame_us
+                              ? format_ms(*time_to_first_frame_us)
+                              : std::string{"-"};
+        return fmt::format("TTFF {} (open {}, input {}, probe {}, decoder {}, "
+                           "renderer {}, load {})",
+                           ttff, format_ms(source_open_us),
+                           format_ms(extractor.open_input_us),
+                           format_ms(extractor.find_stream_info_us),
+                           format_ms(decoder_open_us),
+                           format_ms(renderer_setup_us), format_ms(load_us));
+    }
+
+  private:
+    [[nodiscard]] static std::string format_ms(int64_t us) {
+        return fmt::format("{:.1f}ms", static_cast<double>(us) / 1000.0);
+    }
+};
+
 struct pipeline_stats {
     // Playback progress
     progress_info progress;
@@ -70,13 +221,29 @@ struct pipeline_stats {
     queue_stats video_renderer_queue;
     queue_stats audio_renderer_queue;
 
+    // Decoder throughput
+    decoder_stats video_decoder;
+
+    // Rendered, dropped and underrun counts and A/V drift
+    playback_counters playback;
+
+    // Where samples and frames spend their time
+    stage_latency_stats latency;
+
+    // Startup timeline of the last load()
+    startup_stats startup;
+
     [[nodiscard]] std::string to_string() const {
         return progress.to_string() +
                " | Source: " + format_bytes(media_source_buffered_bytes) +
                " | VTrack: " + video_track_queue.to_string() +
                " | ATrack: " + audio_track_queue.to_string() +
                " | VRender: " + video_renderer_queue.to_string() +
-               " | ARender: " + audio_renderer_queue.to_string();
+               " | ARender: " + audio_renderer_queue.to_string() +
+               " | VDec: " + video_decoder.to_string() +
+               " | Playback: " + playback.to_string() +
+               " | Latency: " + latency.to_string() +
+               " | Startup: " + startup.to_string();
     }
 
   private:
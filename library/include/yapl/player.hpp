@@ -6,6 +6,7 @@
 #include "yapl/input/i_input_handler.hpp"
 #include "yapl/input/i_input_handler_factory.hpp"
 #include "yapl/detail/media_pipeline.hpp"
+#include "yapl/seek_mode.hpp"
 
 #include <string_view>
 
@@ -33,6 +34,12 @@ class player {
     void pause();
     void resume();
     void stop();
+    // Call from the command callback while playing
+    bool seek(int64_t position_ms, seek_mode mode = seek_mode::keyframe);
+    // Jumps to the next or previous keyframe; call like seek()
+    bool step_keyframe(bool forward);
+    // Decode only keyframes, e.g. while stepping through them
+    void set_keyframes_only(bool enabled);
     [[nodiscard]] bool is_paused() const;
     [[nodiscard]] pipeline_stats get_stats() const;
     void set_command_callback(input::command_callback callback);
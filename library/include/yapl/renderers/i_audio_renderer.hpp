@@ -2,7 +2,9 @@
 
 #include "yapl/media_sample.hpp"
 #include "yapl/pipeline_stats.hpp"
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 namespace yapl::renderers {
 
@@ -14,7 +16,19 @@ struct i_audio_renderer {
     virtual void pause() = 0;
     virtual void resume() = 0;
     virtual void stop() = 0;
+    // Drops queued frames and audio already handed to the device, e.g. on
+    // seek. Called from the render thread; a decoder blocked pushing a frame
+    // is released and that frame dropped.
+    virtual void flush() = 0;
     [[nodiscard]] virtual queue_stats get_queue_stats() const = 0;
+    // Clock time at which the next queued audio becomes due, if any.
+    // Called from the render thread after render().
+    [[nodiscard]] virtual std::optional<int64_t>
+    get_next_frame_due_ms() const = 0;
+    // Time frames spent in the queue since construction or stop()
+    [[nodiscard]] virtual latency_stats get_queue_latency() const = 0;
+    // Cumulative; safe to call from any thread while the renderer runs
+    [[nodiscard]] virtual audio_render_counters get_render_counters() const = 0;
 };
 
 } // namespace yapl::renderers
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "yapl/renderers/i_audio_renderer.hpp"
+#include "yapl/pipeline_config.hpp"
 #include "yapl/renderers/media_clock.hpp"
 
 #include <memory>
@@ -9,7 +10,8 @@ namespace yapl::renderers {
 
 struct i_audio_renderer_factory {
     virtual std::unique_ptr<i_audio_renderer>
-    create_audio_renderer(media_clock &clock, size_t queue_size) = 0;
+    create_audio_renderer(media_clock &clock, size_t queue_size,
+                          queue_kind kind) = 0;
     virtual ~i_audio_renderer_factory() = default;
 };
 
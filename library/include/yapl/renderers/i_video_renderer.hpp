@@ -2,7 +2,9 @@
 
 #include "yapl/media_sample.hpp"
 #include "yapl/pipeline_stats.hpp"
+#include <chrono>
 #include <memory>
+#include <optional>
 
 namespace yapl::renderers {
 
@@ -15,8 +17,22 @@ struct i_video_renderer {
     virtual void pause() = 0;
     virtual void resume() = 0;
     virtual void stop() = 0;
+    // Drops queued and pending frames, e.g. on seek. Called from the render
+    // thread while no decoder is pushing.
+    virtual void flush() = 0;
     [[nodiscard]] virtual queue_stats get_queue_stats() const = 0;
     [[nodiscard]] virtual int64_t get_current_position_ms() const = 0;
+    // Video clock time at which the pending frame becomes due, if any.
+    // Called from the render thread after render().
+    [[nodiscard]] virtual std::optional<int64_t>
+    get_next_frame_due_ms() const = 0;
+    // When the first frame since construction or stop() reached the screen
+    [[nodiscard]] virtual std::optional<std::chrono::steady_clock::time_point>
+    get_first_frame_time() const = 0;
+    // Recorded since construction or stop()
+    [[nodiscard]] virtual video_render_latency get_latency_stats() const = 0;
+    // Cumulative; safe to call from any thread while the renderer runs
+    [[nodiscard]] virtual video_render_counters get_render_counters() const = 0;
 };
 
 } // namespace yapl::renderers
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "yapl/pipeline_config.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <optional>
 
 namespace yapl::renderers {
 
@@ -14,13 +19,21 @@ namespace yapl::renderers {
  * buffer latency to maintain A/V sync.
  *
  * Thread-safe for concurrent access from multiple renderer threads.
+ *
+ * In clock_mode::audio_master the audio renderer reports what the device
+ * has played through follow_audio(), and the clock is pulled towards it.
+ *
+ * In clock_mode::free_running the clock does not follow wall time: it only
+ * moves when advance_to() is called, which lets the pipeline step from frame
+ * to frame without waiting.
  */
 class media_clock {
   public:
     media_clock() = default;
+    explicit media_clock(clock_mode mode) : m_mode{mode} {}
 
     /**
-     * @brief Start the clock from zero
+     * @brief Start the clock from its base position (zero unless rebased)
      *
      * Called when first frame is ready to render. Multiple calls are idempotent.
      */
@@ -28,6 +41,7 @@ class media_clock {
         if (!m_started.exchange(true)) {
             m_start_time = std::chrono::steady_clock::now();
             m_pause_offset_ms = 0;
+            m_advanced_ms = 0;
         }
     }
 
@@ -39,8 +53,49 @@ class media_clock {
     void reset() {
         m_started = false;
         m_paused = false;
+        m_base_ms = 0;
         m_pause_offset_ms = 0;
+        m_advanced_ms = 0;
         m_audio_latency_ms = 0;
+        m_audio_position_ms = kNoPosition;
+        m_audio_correction_ms = 0;
+    }
+
+    /**
+     * @brief Move the clock to a new media position
+     * @param position_ms Media time the clock reports once restarted
+     *
+     * Stops the clock so the next start() resumes counting from position_ms.
+     * Called on seek, after the renderers were flushed. Pause state is kept.
+     */
+    void rebase(int64_t position_ms) {
+        m_started = false;
+        m_base_ms = position_ms;
+        m_pause_offset_ms = 0;
+        m_advanced_ms = 0;
+    }
+
+    /**
+     * @brief Get what drives the clock
+     * @return clock_mode given at construction
+     */
+    [[nodiscard]] clock_mode get_mode() const { return m_mode; }
+
+    /**
+     * @brief Move a free-running clock forward
+     * @param position_ms Media time the clock should report
+     *
+     * Never moves the clock backwards. Ignored in realtime mode, while paused
+     * and before start(). Called from the render thread.
+     */
+    void advance_to(int64_t position_ms) {
+        if (m_mode != clock_mode::free_running || !m_started || m_paused) {
+            return;
+        }
+        const auto advanced_ms = position_ms - m_base_ms.load();
+        if (advanced_ms > m_advanced_ms.load()) {
+            m_advanced_ms = advanced_ms;
+        }
     }
 
     /**
@@ -87,25 +142,82 @@ class media_clock {
         return m_audio_latency_ms.load();
     }
 
+    /**
+     * @brief Publish the media time of the audio currently being heard
+     * @param position_ms Audio position, or std::nullopt while there is none
+     *                    (e.g. after a flush)
+     *
+     * Lets the video renderer measure A/V drift against what is audible.
+     */
+    void set_audio_position_ms(std::optional<int64_t> position_ms) {
+        m_audio_position_ms = position_ms.value_or(kNoPosition);
+    }
+
+    /**
+     * @brief Get the last published audio position
+     * @return Audio position in milliseconds, if the audio renderer set one
+     */
+    [[nodiscard]] std::optional<int64_t> get_audio_position_ms() const {
+        const auto position = m_audio_position_ms.load();
+        if (position == kNoPosition) {
+            return std::nullopt;
+        }
+        return position;
+    }
+
+    /**
+     * @brief Correct an audio-master clock towards the audio being played
+     * @param audio_position_ms Media time the device has played up to
+     *
+     * Small errors are slewed out over several calls so video stays smooth;
+     * errors above kAudioResyncMs (e.g. after a device hiccup) are applied at
+     * once. Ignored in other modes, while paused and before start(). Call
+     * only while the device is actually playing audio.
+     */
+    void follow_audio(int64_t audio_position_ms) {
+        if (m_mode != clock_mode::audio_master || !m_started || m_paused) {
+            return;
+        }
+        const auto error_ms = audio_position_ms - get_time_ms();
+        const auto correction_ms = std::abs(error_ms) > kAudioResyncMs
+                                       ? error_ms
+                                       : error_ms / kAudioSlewDivisor;
+        m_base_ms += correction_ms;
+        m_audio_correction_ms += std::abs(correction_ms);
+    }
+
+    /**
+     * @brief Get how far follow_audio() has moved the clock in total
+     * @return Sum of absolute corrections in milliseconds since reset()
+     */
+    [[nodiscard]] int64_t get_audio_correction_ms() const {
+        return m_audio_correction_ms.load();
+    }
+
     /**
      * @brief Get raw playback time since start
-     * @return Elapsed time in milliseconds (excluding pause durations)
+     * @return Base position plus elapsed time in milliseconds (excluding
+     *         pause durations)
      */
     [[nodiscard]] int64_t get_time_ms() const {
+        const auto base_ms = m_base_ms.load();
         if (!m_started) {
-            return 0;
+            return base_ms;
+        }
+        if (m_mode == clock_mode::free_running) {
+            return base_ms + m_advanced_ms.load();
         }
         if (m_paused) {
             auto elapsed =
                 std::chrono::duration_cast<std::chrono::milliseconds>(
                     m_pause_start - m_start_time)
                     .count();
-            return elapsed - m_pause_offset_ms.load();
+            return base_ms + elapsed - m_pause_offset_ms.load();
         }
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
                            std::chrono::steady_clock::now() - m_start_time)
                            .count();
-        return elapsed - m_pause_offset_ms.load();
+        return base_ms + elapsed - m_pause_offset_ms.load();
     }
 
     /**
@@ -113,9 +225,13 @@ class media_clock {
      * @return Time in milliseconds when video frames should be displayed
      *
      * This is the reference time for video frame PTS matching. Video frames
-     * with PTS matching this value should be rendered now.
+     * with PTS matching this value should be rendered now. An audio-master
+     * clock already reports what is audible, so no latency is subtracted.
      */
     [[nodiscard]] int64_t get_video_time_ms() const {
+        if (m_mode == clock_mode::audio_master) {
+            return get_time_ms();
+        }
         return get_time_ms() - m_audio_latency_ms.load();
     }
 
@@ -138,11 +254,23 @@ class media_clock {
     media_clock &operator=(media_clock &&) = delete;
 
   private:
+    static constexpr int64_t kNoPosition =
+        std::numeric_limits<int64_t>::min();
+    // Audio-master: errors beyond this are corrected in one step
+    static constexpr int64_t kAudioResyncMs = 100;
+    // Audio-master: share of a smaller error corrected per follow_audio()
+    static constexpr int64_t kAudioSlewDivisor = 8;
 
+    const clock_mode m_mode{clock_mode::realtime};
     std::chrono::steady_clock::time_point m_start_time;
     std::chrono::steady_clock::time_point m_pause_start;
+    std::atomic<int64_t> m_base_ms{0};
     std::atomic<int64_t> m_pause_offset_ms{0};
+    // Free-running mode: media time advanced since start()
+    std::atomic<int64_t> m_advanced_ms{0};
     std::atomic<int64_t> m_audio_latency_ms{0};
+    std::atomic<int64_t> m_audio_position_ms{kNoPosition};
+    std::atomic<int64_t> m_audio_correction_ms{0};
     std::atomic<bool> m_started{false};
     std::atomic<bool> m_paused{false};
 };
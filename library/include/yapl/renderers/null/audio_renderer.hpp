@@ -0,0 +1,48 @@
+#pragma once
+
+#include "yapl/detail/latency_histogram.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
+#include "yapl/renderers/i_audio_renderer.hpp"
+#include "yapl/renderers/media_clock.hpp"
+#include "yapl/renderers/null/render_pacing.hpp"
+
+#include <atomic>
+#include <optional>
+
+namespace yapl::renderers::null {
+
+/**
+ * @brief Audio renderer without an output device
+ *
+ * Consumes decoded audio without opening a sound card. Never underruns.
+ */
+struct audio_renderer : i_audio_renderer {
+    audio_renderer(media_clock &clock, size_t queue_size, queue_kind kind,
+                   render_pacing pacing);
+    ~audio_renderer() override;
+
+    void push_frame(std::shared_ptr<media_sample> frame) override;
+    void render() override;
+    void pause() override;
+    void resume() override;
+    void stop() override;
+    void flush() override;
+    [[nodiscard]] queue_stats get_queue_stats() const override;
+    [[nodiscard]] std::optional<int64_t>
+    get_next_frame_due_ms() const override;
+    [[nodiscard]] latency_stats get_queue_latency() const override;
+    [[nodiscard]] audio_render_counters get_render_counters() const override;
+
+  private:
+    void consume(const media_sample &frame);
+
+    media_clock &m_clock;
+    render_pacing m_pacing;
+    pipeline_queue<std::shared_ptr<media_sample>> m_frames;
+    latency_histogram m_queue_latency;
+    std::atomic<size_t> m_frames_rendered{0};
+    std::atomic<size_t> m_frames_dropped_late{0};
+    std::optional<std::shared_ptr<media_sample>> m_pending_frame;
+};
+
+} // namespace yapl::renderers::null
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string_view>
+
+namespace yapl::renderers::null {
+
+/**
+ * @brief When a null renderer consumes a frame
+ *
+ * - as_fast_as_possible: as soon as it is queued; measures demux + decode
+ * - clock: when the media clock reaches its PTS, like a real renderer
+ */
+enum class render_pacing { as_fast_as_possible, clock };
+
+constexpr std::string_view render_pacing_to_string(render_pacing pacing) noexcept {
+    switch (pacing) {
+        case render_pacing::as_fast_as_possible: return "fast";
+        case render_pacing::clock:               return "clock";
+        default:                                 return "unknown";
+    }
+}
+
+} // namespace yapl::renderers::null
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "yapl/detail/latency_histogram.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
+#include "yapl/renderers/i_video_renderer.hpp"
+#include "yapl/renderers/media_clock.hpp"
+#include "yapl/renderers/null/render_pacing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+namespace yapl::renderers::null {
+
+/**
+ * @brief Video renderer without output
+ *
+ * Consumes frames without a window or GPU, so the pipeline can run on a
+ * headless machine. Counts frames like the SDL renderer does.
+ */
+struct video_renderer : i_video_renderer {
+    video_renderer(media_clock &clock, size_t queue_size, queue_kind kind,
+                   render_pacing pacing);
+    ~video_renderer() override;
+
+    void resize(size_t width, size_t height) override;
+    void push_frame(std::shared_ptr<media_sample> frame) override;
+    void pause() override;
+    void resume() override;
+    void stop() override;
+    void flush() override;
+    void render() override;
+    [[nodiscard]] queue_stats get_queue_stats() const override;
+    [[nodiscard]] int64_t get_current_position_ms() const override;
+    [[nodiscard]] std::optional<int64_t>
+    get_next_frame_due_ms() const override;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point>
+    get_first_frame_time() const override;
+    [[nodiscard]] video_render_latency get_latency_stats() const override;
+    [[nodiscard]] video_render_counters get_render_counters() const override;
+
+  private:
+    void consume(const media_sample &frame);
+
+    media_clock &m_clock;
+    render_pacing m_pacing;
+    std::atomic<int64_t> m_current_position_ms{0};
+    // Epoch until the first frame was consumed
+    std::atomic<std::chrono::steady_clock::time_point> m_first_frame_time{};
+    std::optional<std::shared_ptr<media_sample>> m_pending_frame;
+    pipeline_queue<std::shared_ptr<media_sample>> m_frames;
+    latency_histogram m_queue_latency;
+    std::atomic<size_t> m_frames_rendered{0};
+    std::atomic<size_t> m_frames_dropped_late{0};
+};
+
+} // namespace yapl::renderers::null
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "yapl/renderers/i_video_renderer_factory.hpp"
+#include "yapl/renderers/null/video_renderer.hpp"
+
+namespace yapl::renderers::null {
+
+struct video_renderer_factory : i_video_renderer_factory {
+    explicit video_renderer_factory(
+        render_pacing pacing = render_pacing::as_fast_as_possible)
+        : m_pacing{pacing} {}
+
+    std::unique_ptr<i_video_renderer>
+    create_video_renderer(media_clock &clock, size_t queue_size,
+                          queue_kind kind) override {
+        return std::make_unique<video_renderer>(clock, queue_size, kind,
+                                                m_pacing);
+    }
+
+  private:
+    render_pacing m_pacing;
+};
+
+} // namespace yapl::renderers::null
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+namespace yapl::renderers {
+
+// A video frame is presented while the clock is within this of its pts:
+// earlier it waits, later it is dropped as late
+inline constexpr int64_t kFrameToleranceMs = 15;
+
+// Audio this far behind the clock is dropped instead of played
+inline constexpr int64_t kLateAudioMs = 100;
+
+} // namespace yapl::renderers
@@ -1,17 +1,41 @@
 #pragma once
 
-#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/latency_histogram.hpp"
+#include "yapl/detail/pcm_ring.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
 #include "yapl/detail/sdl_resource_handles.hpp"
+#include "yapl/detail/spsc_queue.hpp"
 #include "yapl/renderers/i_audio_renderer.hpp"
 #include "yapl/renderers/media_clock.hpp"
 
 #include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
 #include <optional>
+#include <span>
 
 namespace yapl::renderers::sdl {
 
+/**
+ * @brief How audio reaches the SDL device
+ *
+ * - queue: the render loop hands whole frames to SDL_QueueAudio
+ * - callback: SDL pulls from a PCM ring that the audio decoder thread fills,
+ *   so buffer depth is fixed and does not depend on the render loop
+ */
+enum class audio_output_mode { queue, callback };
+
+struct audio_output_config {
+    audio_output_mode mode = audio_output_mode::queue;
+
+    /** Callback mode: audio buffered ahead of the device (ms). The device
+     *  buffer is sized to about half of this. Default: 40 */
+    size_t target_latency_ms = 40;
+};
+
 struct audio_renderer : i_audio_renderer {
-    audio_renderer(media_clock &clock, size_t queue_size);
+    audio_renderer(media_clock &clock, size_t queue_size, queue_kind kind,
+                   audio_output_config output = {});
     ~audio_renderer() override;
 
     void push_frame(std::shared_ptr<media_sample> frame) override;
@@ -19,11 +43,52 @@ struct audio_renderer : i_audio_renderer {
     void pause() override;
     void resume() override;
     void stop() override;
+    void flush() override;
+    // Callback mode reports the PCM ring, in bytes
     [[nodiscard]] queue_stats get_queue_stats() const override;
+    [[nodiscard]] std::optional<int64_t>
+    get_next_frame_due_ms() const override;
+    [[nodiscard]] latency_stats get_queue_latency() const override;
+    [[nodiscard]] audio_render_counters get_render_counters() const override;
 
   private:
+    // Where a frame starts in the PCM ring's byte stream
+    struct pcm_marker {
+        uint64_t offset{0};
+        int64_t pts{0};
+        std::chrono::steady_clock::time_point pushed_at;
+    };
+
+    void render_queued();
+    void render_callback();
+    void push_to_ring(std::shared_ptr<media_sample> frame);
+    // SDL audio thread: copies from the ring, silence when it runs dry
+    void fill_device(std::span<uint8_t> out);
+    static void SDLCALL fill_device_callback(void *userdata, Uint8 *stream,
+                                             int len);
+
     media_clock &m_clock;
-    blocking_queue<std::shared_ptr<media_sample>> m_frames;
+    audio_output_config m_output;
+    pipeline_queue<std::shared_ptr<media_sample>> m_frames;
+    latency_histogram m_queue_latency;
+    std::atomic<size_t> m_frames_rendered{0};
+    std::atomic<size_t> m_frames_dropped_late{0};
+    std::atomic<size_t> m_underruns{0};
+    // Media time up to which audio was handed to the device
+    std::optional<int64_t> m_queued_until_ms;
+    // Device ran dry and was not fed since
+    bool m_starved{false};
+    int64_t m_last_log_time_ms{0};
+    // Callback mode. Declared before the device so they outlive its callback
+    std::optional<pcm_ring> m_pcm_ring;
+    std::optional<spsc_queue<pcm_marker>> m_markers;
+    std::optional<pcm_marker> m_current_marker;
+    std::optional<pcm_marker> m_next_marker;
+    int64_t m_device_buffer_ms{0};
+    // Set once audio entered the ring since the last flush
+    std::atomic<bool> m_ring_fed{false};
+    // Written by the SDL audio thread
+    std::atomic<bool> m_device_starved{false};
     std::optional<detail::sdl_audio_device_handle> m_audio_device;
     std::optional<std::shared_ptr<media_sample>> m_pending_frame;
 };
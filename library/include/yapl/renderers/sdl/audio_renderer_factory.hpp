@@ -6,10 +6,18 @@
 namespace yapl::renderers::sdl {
 
 struct audio_renderer_factory : i_audio_renderer_factory {
+    explicit audio_renderer_factory(audio_output_config output = {})
+        : m_output{output} {}
+
     std::unique_ptr<i_audio_renderer>
-    create_audio_renderer(media_clock &clock, size_t queue_size) override {
-        return std::make_unique<audio_renderer>(clock, queue_size);
+    create_audio_renderer(media_clock &clock, size_t queue_size,
+                          queue_kind kind) override {
+        return std::make_unique<audio_renderer>(clock, queue_size, kind,
+                                                m_output);
     }
+
+  private:
+    audio_output_config m_output;
 };
 
 } // namespace yapl::renderers::sdl
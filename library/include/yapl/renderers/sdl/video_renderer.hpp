@@ -1,19 +1,21 @@
 #pragma once
 
-#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/latency_histogram.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
 #include "yapl/detail/sdl_resource_handles.hpp"
 #include "yapl/renderers/i_video_renderer.hpp"
 #include "yapl/renderers/media_clock.hpp"
 
 #include <SDL2/SDL.h>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <optional>
 
 namespace yapl::renderers::sdl {
 
 struct video_renderer : i_video_renderer {
-    video_renderer(media_clock &clock, size_t queue_size);
+    video_renderer(media_clock &clock, size_t queue_size, queue_kind kind);
     ~video_renderer() override;
 
     void resize(size_t width, size_t height) override;
@@ -21,17 +23,40 @@ struct video_renderer : i_video_renderer {
     void pause() override;
     void resume() override;
     void stop() override;
+    void flush() override;
     void render() override;
     [[nodiscard]] queue_stats get_queue_stats() const override;
     [[nodiscard]] int64_t get_current_position_ms() const override;
+    [[nodiscard]] std::optional<int64_t>
+    get_next_frame_due_ms() const override;
+    [[nodiscard]] std::optional<std::chrono::steady_clock::time_point>
+    get_first_frame_time() const override;
+    [[nodiscard]] video_render_latency get_latency_stats() const override;
+    [[nodiscard]] video_render_counters get_render_counters() const override;
 
   private:
+    void upload_frame(const media_sample &frame);
+    // Compares the presented frame with the audio being heard
+    void record_drift(int64_t video_pts_ms);
+
     media_clock &m_clock;
     size_t m_width;
     size_t m_height;
     std::atomic<int64_t> m_current_position_ms{0};
+    // Epoch until the first present
+    std::atomic<std::chrono::steady_clock::time_point> m_first_frame_time{};
     std::optional<std::shared_ptr<media_sample>> m_pending_frame;
-    blocking_queue<std::shared_ptr<media_sample>> m_frames;
+    pipeline_queue<std::shared_ptr<media_sample>> m_frames;
+    latency_histogram m_queue_latency;
+    latency_histogram m_upload_latency;
+    latency_histogram m_present_latency;
+    std::atomic<size_t> m_frames_rendered{0};
+    std::atomic<size_t> m_frames_dropped_late{0};
+    std::atomic<size_t> m_drift_samples{0};
+    std::atomic<int64_t> m_drift_last_ms{0};
+    std::atomic<int64_t> m_drift_sum_ms{0};
+    std::atomic<int64_t> m_drift_max_abs_ms{0};
+    int64_t m_last_log_time_ms{0};
     std::optional<detail::sdl_window_handle> m_window;
     std::optional<detail::sdl_renderer_handle> m_renderer;
     std::optional<detail::sdl_texture_handle> m_texture;
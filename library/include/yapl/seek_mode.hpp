@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string_view>
+
+namespace yapl {
+
+/**
+ * @brief Where playback resumes after a seek
+ *
+ * - keyframe: at the keyframe at or before the target. Fast, since nothing
+ *   is decoded in vain, but may land up to one GOP early.
+ * - accurate: at the target itself. Decodes from the preceding keyframe and
+ *   discards every frame before the target.
+ */
+enum class seek_mode { keyframe, accurate };
+
+constexpr std::string_view seek_mode_to_string(seek_mode mode) noexcept {
+    switch (mode) {
+        case seek_mode::keyframe: return "keyframe";
+        case seek_mode::accurate: return "accurate";
+        default:                  return "unknown";
+    }
+}
+
+} // namespace yapl
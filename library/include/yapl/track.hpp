@@ -1,28 +1,35 @@
 #pragma once
 
-#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/latency_histogram.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
 #include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
 #include "yapl/pipeline_stats.hpp"
 #include "yapl/track_info.hpp"
+#include <atomic>
 #include <memory>
 
 namespace yapl {
 
 struct track {
   public:
-    explicit track(std::shared_ptr<track_info> info);
+    track(std::shared_ptr<track_info> info, size_t queue_size,
+          queue_kind kind);
     void push_sample(std::shared_ptr<media_sample> sample);
     read_sample_result pop_sample();
     void set_data_source_reached_eos();
     void shutdown();
     [[nodiscard]] std::shared_ptr<track_info> get_info() const;
     [[nodiscard]] queue_stats get_queue_stats() const;
+    // Time samples spent in the queue
+    [[nodiscard]] latency_stats get_wait_stats() const;
 
   private:
     std::shared_ptr<track_info> m_track_info;
-    bool m_data_source_eos_reached;
+    std::atomic_bool m_data_source_eos_reached;
     size_t m_buffered_duration;
-    blocking_queue<std::shared_ptr<media_sample>> m_sample_queue;
+    pipeline_queue<std::shared_ptr<media_sample>> m_sample_queue;
+    latency_histogram m_wait_latency;
 };
 
 } // namespace yapl
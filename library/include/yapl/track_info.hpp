@@ -1,5 +1,7 @@
 #pragma once
 
+#include "yapl/video_bitstream.hpp"
+
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -22,7 +24,21 @@ constexpr std::string_view track_type_to_string(track_type type) noexcept {
     }
 }
 
-// Constexpr bit extraction helpers for AVC parsing
+// Video codecs whose configuration records and sample framing the extractor
+// understands; anything else is passed through untouched
+enum class video_codec { unknown, h264, hevc, vp9, av1 };
+
+constexpr std::string_view video_codec_to_string(video_codec codec) noexcept {
+    switch (codec) {
+        case video_codec::h264: return "h264";
+        case video_codec::hevc: return "hevc";
+        case video_codec::vp9:  return "vp9";
+        case video_codec::av1:  return "av1";
+        default:                return "unknown";
+    }
+}
+
+// Constexpr bit extraction helpers for AVC/HEVC parsing
 constexpr uint8_t extract_nal_size_length(uint8_t byte) noexcept {
     return (byte & 0b00000011) + 1;
 }
@@ -31,34 +47,43 @@ constexpr uint8_t extract_sps_count(uint8_t byte) noexcept {
     return byte & 0b00011111;
 }
 
+/**
+ * @brief Codec configuration record from the container, parsed per codec
+ *
+ * - h264: avcC (ISO 14496-15), length-prefixed SPS/PPS NAL units
+ * - hevc: hvcC, VPS/SPS/PPS arrays
+ * - av1: av1C, whose config OBUs (sequence header) become parameter_sets
+ * - vp9 and others: no record is parsed; samples (including VP9
+ *   superframes) go to the decoder as demuxed
+ *
+ * Missing, truncated or Annex-B extradata (e.g. from MPEG-TS) leaves
+ * nal_size_length at 0 and parameter_sets empty. raw_data always holds the
+ * bytes as given.
+ */
 struct video_extra_data {
-    explicit video_extra_data(std::span<uint8_t> data) {
-        raw_data.assign(data.begin(), data.end());
-        configuration_version = data[0];
-        avc_profile_indication = data[1];
-        profile_compatibility = data[2];
-        avc_level_indication = data[3];
-        nal_size_length = extract_nal_size_length(data[4]);
-        sps_count = extract_sps_count(data[5]);
-        sps_length = static_cast<uint16_t>(data[6]) << 8 | data[7];
-        sps_data.assign(&data[8], &data[8 + sps_length]);
-        pps_count = data[8 + sps_length];
-        pps_length = static_cast<uint16_t>(data[9 + sps_length]) << 8 |
-                     data[10 + sps_length];
-        pps_data.assign(data.begin() + 11 + sps_length, data.end());
-    }
-
-    uint8_t configuration_version;
-    uint8_t avc_profile_indication;
-    uint8_t profile_compatibility;
-    uint8_t avc_level_indication;
-    uint8_t nal_size_length; 
-    uint8_t sps_count; 
-    uint16_t sps_length;
+    video_extra_data(video_codec codec, std::span<const uint8_t> data);
+
+    video_codec codec;
+    uint8_t configuration_version{0};
+    // profile_idc/level_idc for H.264 and HEVC, seq_profile/seq_level_idx_0
+    // for AV1
+    uint8_t profile{0};
+    uint8_t level{0};
+    // Luma bit depth, e.g. 10 for HEVC Main10; 0 if the record does not
+    // carry it
+    uint8_t bit_depth{0};
+    // Length prefix of H.264/HEVC samples; 0 if samples are not
+    // length-prefixed NAL units
+    uint8_t nal_size_length{0};
+    uint8_t sps_count{0};
+    uint16_t sps_length{0};
+    // First SPS and PPS
     std::vector<uint8_t> sps_data;
-    uint8_t pps_count;
+    uint8_t pps_count{0};
     uint16_t pps_length{0};
     std::vector<uint8_t> pps_data;
+    // Every parameter set NAL unit or config OBU, in record order
+    std::vector<std::vector<uint8_t>> parameter_sets;
     std::vector<uint8_t> raw_data;
 };
 
@@ -85,24 +110,30 @@ struct video_track_uniques {
     double frame_rate;
     size_t bit_rate;
     std::shared_ptr<video_extra_data> extra_data;
+    video_bitstream bitstream{video_bitstream::passthrough};
 
+    // Parameter sets as Annex-B NAL units
     std::vector<uint8_t> get_extra_data() const {
         std::vector<uint8_t> result;
-        result.reserve(sizeof(nal_start_code) * 2 +
-                       extra_data->sps_data.size() +
-                       extra_data->pps_data.size());
-
-        result.insert(result.end(), std::begin(nal_start_code),
-                      std::end(nal_start_code));
-        result.insert(result.end(), extra_data->sps_data.begin(),
-                      extra_data->sps_data.end());
-        result.insert(result.end(), std::begin(nal_start_code),
-                      std::end(nal_start_code));
-        result.insert(result.end(), extra_data->pps_data.begin(),
-                      extra_data->pps_data.end());
-
+        for (const auto &parameter_set : extra_data->parameter_sets) {
+            result.insert(result.end(), std::begin(nal_start_code),
+                          std::end(nal_start_code));
+            result.insert(result.end(), parameter_set.begin(),
+                          parameter_set.end());
+        }
         return result;
     }
+
+    // Codec configuration matching the sample framing: the record as
+    // demuxed for passthrough, start-code parameter sets for converted
+    // samples
+    std::vector<uint8_t> get_decoder_config() const {
+        if (bitstream == video_bitstream::annexb &&
+            extra_data->nal_size_length != 0) {
+            return get_extra_data();
+        }
+        return extra_data->raw_data;
+    }
 };
 
 using audio_track_specifics_t =
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string_view>
+
+namespace yapl {
+
+/**
+ * @brief How the extractor frames video samples
+ *
+ * - passthrough: as demuxed, e.g. length-prefixed AVCC from MP4/MKV; the
+ *   decoder reads the prefix size from the codec configuration record
+ * - annexb: rewritten with 00 00 00 01 start codes, for consumers that need
+ *   them (hardware decoders, raw .h264 dumps)
+ */
+enum class video_bitstream { passthrough, annexb };
+
+constexpr std::string_view video_bitstream_to_string(video_bitstream format) noexcept {
+    switch (format) {
+        case video_bitstream::passthrough: return "passthrough";
+        case video_bitstream::annexb:      return "annexb";
+        default:                           return "unknown";
+    }
+}
+
+} // namespace yapl
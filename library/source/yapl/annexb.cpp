@@ -0,0 +1,69 @@
+#include "yapl/detail/annexb.hpp"
+
+#include <cstring>
+
+namespace yapl {
+
+namespace {
+constexpr uint8_t kStartCode[4] = {0, 0, 0, 1};
+
+size_t read_nal_length(const uint8_t *prefix, size_t nal_length_size) {
+    size_t length = 0;
+    for (size_t i = 0; i < nal_length_size; ++i) {
+        length = (length << 8) | prefix[i];
+    }
+    return length;
+}
+} // namespace
+
+std::optional<size_t> avcc_to_annexb_size(std::span<const uint8_t> avcc,
+                                          size_t nal_length_size) {
+    if (nal_length_size == 0 || nal_length_size > sizeof(kStartCode)) {
+        return std::nullopt;
+    }
+    size_t position = 0;
+    size_t size = 0;
+    while (position + nal_length_size <= avcc.size()) {
+        const auto length =
+            read_nal_length(avcc.data() + position, nal_length_size);
+        position += nal_length_size;
+        if (length > avcc.size() - position) {
+            return std::nullopt;
+        }
+        position += length;
+        size += sizeof(kStartCode) + length;
+    }
+    return size;
+}
+
+void avcc_to_annexb(std::span<const uint8_t> avcc, size_t nal_length_size,
+                    std::span<uint8_t> out) {
+    size_t position = 0;
+    auto *write = out.data();
+    while (position + nal_length_size <= avcc.size()) {
+        const auto length =
+            read_nal_length(avcc.data() + position, nal_length_size);
+        position += nal_length_size;
+        std::memcpy(write, kStartCode, sizeof(kStartCode));
+        std::memcpy(write + sizeof(kStartCode), avcc.data() + position,
+                    length);
+        write += sizeof(kStartCode) + length;
+        position += length;
+    }
+}
+
+std::optional<size_t> avcc_to_annexb_in_place(std::span<uint8_t> data) {
+    constexpr size_t kPrefixSize = sizeof(kStartCode);
+    size_t position = 0;
+    while (position + kPrefixSize <= data.size()) {
+        const auto length = read_nal_length(data.data() + position, kPrefixSize);
+        if (length > data.size() - position - kPrefixSize) {
+            return std::nullopt;
+        }
+        std::memcpy(data.data() + position, kStartCode, kPrefixSize);
+        position += kPrefixSize + length;
+    }
+    return position;
+}
+
+} // namespace yapl
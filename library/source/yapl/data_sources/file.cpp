@@ -68,4 +68,25 @@ void file::reset() {
     m_file.clear(); // Clear any EOF or error flags
 }
 
+bool file::seek(size_t offset) {
+    if (!m_file.is_open()) {
+        throw std::runtime_error("File is not open: " + m_file_path.string());
+    }
+    if (offset > m_file_size) {
+        return false;
+    }
+
+    m_file.clear(); // Clear any EOF or error flags
+    m_file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    m_current_position = offset;
+    return static_cast<bool>(m_file);
+}
+
+std::optional<size_t> file::size() const {
+    if (!m_file.is_open()) {
+        return std::nullopt;
+    }
+    return m_file_size;
+}
+
 } // namespace yapl::data_sources
@@ -1,13 +1,60 @@
 #include "yapl/detail/data_sources/http.hpp"
 
 #include <algorithm>
-#include <chrono>
+#include <cctype>
+#include <cstring>
 #include <curl/curl.h>
 #include <stdexcept>
+#include <string_view>
 
 namespace yapl::data_sources {
 
-http::http(std::string url) : m_url(std::move(url)) {
+namespace {
+// Value of a header line if its name matches (case-insensitive, as HTTP/2
+// sends lowercase names), without leading whitespace
+std::optional<std::string_view> header_value(std::string_view line,
+                                             std::string_view name) {
+    if (line.size() < name.size()) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(line[i])) !=
+            std::tolower(static_cast<unsigned char>(name[i]))) {
+            return std::nullopt;
+        }
+    }
+    auto value = line.substr(name.size());
+    value.remove_prefix(std::min(value.find_first_not_of(" \t"),
+                                 value.size()));
+    return value;
+}
+
+// Total size from "bytes <first>-<last>/<total>", nullopt for "/*"
+std::optional<size_t> content_range_total(std::string_view value) {
+    const auto slash = value.find('/');
+    if (slash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    try {
+        return std::stoull(std::string(value.substr(slash + 1)));
+    } catch (...) {
+        return std::nullopt;
+    }
+}
+
+// Longest the download thread sleeps in curl_multi_poll() without a wakeup
+constexpr int kPollTimeoutMs = 1000;
+} // namespace
+
+http::http(std::string url, const source_config &config)
+    : m_url(std::move(url)),
+      m_capacity{std::max(config.http_buffer_size,
+                          config.http_back_buffer_size +
+                              2 * kTransferChunkSize)},
+      m_back_buffer_size{config.http_back_buffer_size},
+      m_connections{std::max<size_t>(config.http_connections, 1)},
+      m_segment_size{std::max(config.http_segment_size, kTransferChunkSize)},
+      m_min_buffer_size{config.http_buffer_min_kb * 1024} {
     curl_global_init(CURL_GLOBAL_DEFAULT);
 }
 
@@ -22,65 +69,67 @@ void http::open() {
     }
 
     m_curl_handle = curl_easy_init();
-    if (!m_curl_handle) {
+    m_multi_handle = curl_multi_init();
+    if (!m_curl_handle || !m_multi_handle) {
+        close();
         throw std::runtime_error("Failed to initialize CURL handle");
     }
+    m_buffer.resize(m_capacity);
 
     // Reset state
-    m_buffer.clear();
-    m_read_position = 0;
-    m_download_complete = false;
-    m_stop_requested = false;
-    m_download_error = false;
-    m_error_message.clear();
     m_content_length = 0;
+    m_accepts_ranges = false;
 
     // Configure CURL options
     curl_easy_setopt(m_curl_handle, CURLOPT_URL, m_url.c_str());
     curl_easy_setopt(m_curl_handle, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(m_curl_handle, CURLOPT_WRITEDATA, this);
     curl_easy_setopt(m_curl_handle, CURLOPT_HEADERFUNCTION, header_callback);
-    curl_easy_setopt(m_curl_handle, CURLOPT_HEADERDATA, this);
     curl_easy_setopt(m_curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(m_curl_handle, CURLOPT_MAXREDIRS, 10L);
     curl_easy_setopt(m_curl_handle, CURLOPT_USERAGENT, "yapl/1.0");
     curl_easy_setopt(m_curl_handle, CURLOPT_ACCEPT_ENCODING, "");  // Accept all encodings
-    curl_easy_setopt(m_curl_handle, CURLOPT_BUFFERSIZE, 256 * 1024L);  // 256KB buffer
+    curl_easy_setopt(m_curl_handle, CURLOPT_BUFFERSIZE,
+                     static_cast<long>(kTransferChunkSize));
 
     // SSL options
     curl_easy_setopt(m_curl_handle, CURLOPT_SSL_VERIFYPEER, 1L);
     curl_easy_setopt(m_curl_handle, CURLOPT_SSL_VERIFYHOST, 2L);
 
-    // Start download in background thread
-    m_download_thread = std::thread(&http::download_thread_func, this);
+    start_transfer(0);
 
-    // Wait for minimum buffer or completion
+    // Wait for the response headers, so errors and the resource size are
+    // known, then for the minimum buffer or a full ring
     {
         std::unique_lock lock(m_buffer_mutex);
         m_data_available_cv.wait(lock, [this] {
-            return m_buffer.size() >= kMinBufferBeforeRead ||
+            return (m_headers_received &&
+                    (m_write_offset - m_read_offset >= m_min_buffer_size ||
+                     m_paused)) ||
                    m_download_complete ||
                    m_download_error;
         });
     }
 
     if (m_download_error) {
-        if (m_download_thread.joinable()) {
-            m_download_thread.join();
-        }
-        throw std::runtime_error("HTTP download failed: " + m_error_message);
+        const std::string error = m_error_message;
+        close();
+        throw std::runtime_error("HTTP download failed: " + error);
     }
 
     m_is_open = true;
 }
 
 void http::close() {
-    m_stop_requested = true;
+    stop_transfer();
 
-    if (m_download_thread.joinable()) {
-        m_download_thread.join();
+    for (CURL *handle : m_idle_handles) {
+        curl_easy_cleanup(handle);
+    }
+    m_idle_handles.clear();
+    if (m_multi_handle) {
+        curl_multi_cleanup(m_multi_handle);
+        m_multi_handle = nullptr;
     }
-
     if (m_curl_handle) {
         curl_easy_cleanup(m_curl_handle);
         m_curl_handle = nullptr;
@@ -88,7 +137,45 @@ void http::close() {
 
     m_is_open = false;
     m_buffer.clear();
-    m_read_position = 0;
+    m_buffer.shrink_to_fit();
+    m_buffer_offset = 0;
+    m_write_offset = 0;
+    m_read_offset = 0;
+    m_paused = false;
+}
+
+void http::start_transfer(size_t offset) {
+    {
+        std::lock_guard lock(m_buffer_mutex);
+        m_buffer_offset = offset;
+        m_write_offset = offset;
+        m_read_offset = offset;
+        m_reserved_until = offset;
+        m_paused = false;
+        m_headers_received = false;
+    }
+    m_next_offset = offset;
+    // After a seek the first response has already answered this
+    m_probed = m_accepts_ranges && m_content_length > 0;
+    m_resume_requested = false;
+    m_download_complete = false;
+    m_stop_requested = false;
+    m_download_error = false;
+    m_error_message.clear();
+
+    // Start download in background thread
+    m_download_thread = std::thread(&http::download_thread_func, this);
+}
+
+void http::stop_transfer() {
+    m_stop_requested = true;
+    if (m_multi_handle) {
+        curl_multi_wakeup(m_multi_handle);
+    }
+
+    if (m_download_thread.joinable()) {
+        m_download_thread.join();
+    }
 }
 
 bool http::is_open() const {
@@ -110,9 +197,11 @@ size_t http::read_data(size_t size, std::span<uint8_t> buffer) {
 
     std::unique_lock lock(m_buffer_mutex);
 
-    // Wait for data if not enough available and download still in progress
+    // Wait for data if not enough available and download still in progress.
+    // A paused transfer has filled the ring: hand out what is there.
     m_data_available_cv.wait(lock, [this, size] {
-        return (m_buffer.size() - m_read_position) >= size ||
+        return m_write_offset - m_read_offset >= size ||
+               (m_paused && m_write_offset > m_read_offset) ||
                m_download_complete ||
                m_download_error;
     });
@@ -121,85 +210,387 @@ size_t http::read_data(size_t size, std::span<uint8_t> buffer) {
         throw std::runtime_error("HTTP download error: " + m_error_message);
     }
 
-    const size_t bytes_available = m_buffer.size() - m_read_position;
+    const size_t bytes_available = m_write_offset - m_read_offset;
     if (bytes_available == 0) {
         return 0;  // EOF
     }
 
     const size_t bytes_to_read = std::min(size, bytes_available);
-    std::copy_n(m_buffer.begin() + static_cast<std::ptrdiff_t>(m_read_position),
-                bytes_to_read,
-                buffer.begin());
-    m_read_position += bytes_to_read;
+    const size_t start = m_read_offset % m_capacity;
+    const size_t first = std::min(bytes_to_read, m_capacity - start);
+    std::memcpy(buffer.data(), m_buffer.data() + start, first);
+    std::memcpy(buffer.data() + first, m_buffer.data(), bytes_to_read - first);
+    m_read_offset += bytes_to_read;
 
+    release_consumed();
     return bytes_to_read;
 }
 
 size_t http::available() const {
     std::lock_guard lock(m_buffer_mutex);
-    return m_buffer.size() - m_read_position;
+    return m_write_offset - m_read_offset;
 }
 
 void http::reset() {
+    if (m_is_open) {
+        seek(0);
+    }
+}
+
+bool http::seek(size_t offset) {
+    if (!m_is_open) {
+        throw std::runtime_error("HTTP source is not open: " + m_url);
+    }
+
+    {
+        std::lock_guard lock(m_buffer_mutex);
+        if (offset >= m_buffer_offset && offset <= m_write_offset) {
+            m_read_offset = offset;
+            release_consumed();
+            return true;
+        }
+    }
+
+    const size_t content_length = m_content_length;
+    if (!m_accepts_ranges ||
+        (content_length > 0 && offset > content_length)) {
+        return false;
+    }
+
+    stop_transfer();
+    if (offset == content_length) {
+        // Nothing left to request: reads report EOF
+        std::lock_guard lock(m_buffer_mutex);
+        m_buffer_offset = offset;
+        m_write_offset = offset;
+        m_read_offset = offset;
+        m_reserved_until = offset;
+        m_paused = false;
+        return true;
+    }
+    start_transfer(offset);
+    return true;
+}
+
+std::optional<size_t> http::size() const {
+    if (m_content_length == 0) {
+        return std::nullopt;
+    }
+    return m_content_length;
+}
+
+void http::schedule_transfers() {
+    while (!m_stop_requested && m_next_offset != kOpenEnded) {
+        const size_t length = m_content_length;
+        if (length > 0 && m_next_offset >= length) {
+            return;
+        }
+
+        // One "<offset>-" request, paced by the write callback
+        if (m_connections == 1 ||
+            (m_probed && (!m_accepts_ranges || length == 0))) {
+            if (m_transfers.empty()) {
+                add_transfer(m_next_offset, kOpenEnded);
+                m_next_offset = kOpenEnded;
+            }
+            return;
+        }
+
+        const auto active = std::count_if(
+            m_transfers.begin(), m_transfers.end(),
+            [](const auto &t) { return !t->done; });
+        // Until the first response shows that ranges work, one at a time
+        if (static_cast<size_t>(active) >= (m_probed ? m_connections : 1)) {
+            return;
+        }
+
+        size_t size = m_segment_size;
+        if (length > 0) {
+            size = std::min(size, length - m_next_offset);
+        }
+        {
+            std::lock_guard lock(m_buffer_mutex);
+            const size_t free = free_space();
+            if (free < kTransferChunkSize) {
+                // Readers asking for more than the ring holds take what
+                // is there
+                m_paused = true;
+                m_data_available_cv.notify_all();
+                return;
+            }
+            size = std::min(size, free);
+            m_reserved_until = m_next_offset + size;
+        }
+        add_transfer(m_next_offset, m_next_offset + size);
+        m_next_offset += size;
+    }
+}
+
+void http::add_transfer(size_t begin, size_t end) {
+    CURL *handle = nullptr;
+    if (m_idle_handles.empty()) {
+        handle = curl_easy_duphandle(m_curl_handle);
+    } else {
+        handle = m_idle_handles.back();
+        m_idle_handles.pop_back();
+    }
+
+    auto t = std::make_unique<transfer>(transfer{
+        .owner = this, .handle = handle, .begin = begin, .end = end,
+        .written = begin});
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, t.get());
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, t.get());
+
+    // "<first>-[<last>]", both inclusive
+    std::string range;
+    if (end != kOpenEnded) {
+        range = std::to_string(begin) + "-" + std::to_string(end - 1);
+    } else if (begin > 0) {
+        range = std::to_string(begin) + "-";
+    }
+    curl_easy_setopt(handle, CURLOPT_RANGE,
+                     range.empty() ? nullptr : range.c_str());
+
+    curl_multi_add_handle(m_multi_handle, handle);
+    m_transfers.push_back(std::move(t));
+}
+
+bool http::finish_transfer(CURL *handle, int result) {
+    const auto it = std::find_if(
+        m_transfers.begin(), m_transfers.end(),
+        [handle](const auto &t) { return t->handle == handle; });
+    if (it == m_transfers.end()) {
+        return true;
+    }
+    transfer &t = **it;
+
+    long http_code = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &http_code);
+    curl_multi_remove_handle(m_multi_handle, handle);
+    m_idle_handles.push_back(handle);
+    t.handle = nullptr;
+
+    if (result != CURLE_OK) {
+        // The header callback may have recorded a better reason
+        if (m_error_message.empty()) {
+            m_error_message =
+                curl_easy_strerror(static_cast<CURLcode>(result));
+        }
+        return false;
+    }
+    if (http_code >= 400) {
+        m_error_message = "HTTP error: " + std::to_string(http_code);
+        return false;
+    }
+    if (t.end != kOpenEnded && t.written < t.end) {
+        m_error_message = "Range response ended early at " +
+                          std::to_string(t.written);
+        return false;
+    }
+
     std::lock_guard lock(m_buffer_mutex);
-    m_read_position = 0;
+    t.done = true;
+    commit();
+    return true;
+}
+
+void http::commit() {
+    const size_t before = m_write_offset;
+    while (!m_transfers.empty()) {
+        const transfer &front = *m_transfers.front();
+        m_write_offset = std::max(m_write_offset, front.written);
+        if (!front.done) {
+            break;
+        }
+        m_transfers.pop_front();
+    }
+    m_reserved_until = std::max(m_reserved_until, m_write_offset);
+
+    if (m_write_offset != before) {
+        m_data_available_cv.notify_all();
+    }
+}
+
+void http::release_consumed() {
+    // Bytes more than the back-buffer behind the read position may be
+    // overwritten
+    if (m_read_offset > m_buffer_offset + m_back_buffer_size) {
+        m_buffer_offset = m_read_offset - m_back_buffer_size;
+    }
+
+    if (m_paused && free_space() >= kTransferChunkSize) {
+        m_paused = false;
+        // curl_easy_pause() has to run on the thread driving the transfer
+        m_resume_requested = true;
+        curl_multi_wakeup(m_multi_handle);
+    }
+}
+
+size_t http::free_space() const {
+    return m_capacity - (std::max(m_reserved_until, m_write_offset) -
+                         m_buffer_offset);
 }
 
 size_t http::write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
-    auto* self = static_cast<http*>(userdata);
+    auto* t = static_cast<transfer*>(userdata);
+    auto* self = t->owner;
     const size_t total_size = size * nmemb;
 
     if (self->m_stop_requested) {
         return 0;  // Abort transfer
     }
 
+    // A ranged response never runs past its end; treat excess as an error
+    if (t->end != kOpenEnded && total_size > t->end - t->written) {
+        return 0;
+    }
+
     {
         std::lock_guard lock(self->m_buffer_mutex);
-        self->m_buffer.insert(self->m_buffer.end(),
-                              reinterpret_cast<uint8_t*>(ptr),
-                              reinterpret_cast<uint8_t*>(ptr) + total_size);
+        // Ranged transfers write into space reserved when they were added
+        if (t->end == kOpenEnded && total_size > self->free_space()) {
+            // curl keeps the chunk and delivers it again after resuming
+            self->m_paused = true;
+            self->m_data_available_cv.notify_all();
+            return CURL_WRITEFUNC_PAUSE;
+        }
+
+        const size_t start = t->written % self->m_capacity;
+        const size_t first = std::min(total_size, self->m_capacity - start);
+        std::memcpy(self->m_buffer.data() + start, ptr, first);
+        std::memcpy(self->m_buffer.data(), ptr + first, total_size - first);
+        t->written += total_size;
+        self->commit();
     }
 
-    self->m_data_available_cv.notify_one();
     return total_size;
 }
 
 size_t http::header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
-    auto* self = static_cast<http*>(userdata);
+    auto* t = static_cast<transfer*>(userdata);
+    auto* self = t->owner;
     const size_t total_size = size * nitems;
     const std::string header(buffer, total_size);
 
-    // Parse Content-Length header
-    constexpr std::string_view content_length_prefix = "Content-Length:";
-    if (header.starts_with(content_length_prefix)) {
-        const std::string value = header.substr(content_length_prefix.size());
+    // Every response (redirects included) starts with a status line
+    if (header.starts_with("HTTP/")) {
+        const auto space = header.find(' ');
+        t->status = space == std::string::npos
+                        ? 0
+                        : std::strtol(header.c_str() + space + 1, nullptr, 10);
+        return total_size;
+    }
+
+    // A 200 carries the whole resource; a 206 only its range, with the
+    // total in Content-Range
+    if (auto value = header_value(header, "Content-Length:");
+        value && t->status == 200) {
         try {
-            self->m_content_length = std::stoull(value);
+            self->m_content_length = std::stoull(std::string(*value));
         } catch (...) {
             // Ignore parse errors
         }
     }
 
+    if (auto value = header_value(header, "Content-Range:")) {
+        if (auto total = content_range_total(*value)) {
+            self->m_content_length = *total;
+        }
+    }
+
+    if (auto value = header_value(header, "Accept-Ranges:")) {
+        self->m_accepts_ranges = value->starts_with("bytes");
+    }
+
+    // Blank line: end of this response's headers; redirects have more
+    if (header == "\r\n" &&
+        ((t->status >= 200 && t->status < 300) || t->status >= 400)) {
+        std::lock_guard lock(self->m_buffer_mutex);
+        self->m_headers_received = true;
+        self->m_data_available_cv.notify_all();
+    }
+    if (header == "\r\n" && (t->status == 200 || t->status == 206)) {
+        self->m_probed = true;
+        if (t->status == 206) {
+            self->m_accepts_ranges = true;
+        } else if (t->begin > 0) {
+            // The body would start at byte 0, not where it was asked for
+            self->m_error_message = "Server ignored Range request";
+            return 0;
+        } else if (t->end != kOpenEnded) {
+            // Ranges are not honored: take the whole body sequentially
+            self->m_accepts_ranges = false;
+            t->end = kOpenEnded;
+            self->m_next_offset = kOpenEnded;
+        }
+    }
+
     return total_size;
 }
 
 void http::download_thread_func() {
-    const CURLcode result = curl_easy_perform(m_curl_handle);
+    bool failed = false;
+
+    while (!m_stop_requested && !failed) {
+        if (m_resume_requested.exchange(false)) {
+            for (const auto &t : m_transfers) {
+                if (t->handle && t->end == kOpenEnded) {
+                    curl_easy_pause(t->handle, CURLPAUSE_CONT);
+                }
+            }
+        }
 
-    if (result != CURLE_OK && result != CURLE_ABORTED_BY_CALLBACK) {
-        m_download_error = true;
-        m_error_message = curl_easy_strerror(result);
+        schedule_transfers();
+        {
+            std::lock_guard lock(m_buffer_mutex);
+            // Nothing in flight and nothing waiting for ring space
+            if (m_transfers.empty() && !m_paused) {
+                break;
+            }
+        }
+
+        int running = 0;
+        if (curl_multi_perform(m_multi_handle, &running) != CURLM_OK) {
+            m_error_message = "curl_multi_perform failed";
+            failed = true;
+            break;
+        }
+
+        bool finished = false;
+        int pending = 0;
+        while (CURLMsg *message =
+                   curl_multi_info_read(m_multi_handle, &pending)) {
+            if (message->msg == CURLMSG_DONE) {
+                finished = true;
+                if (!finish_transfer(message->easy_handle,
+                                     message->data.result)) {
+                    failed = true;
+                }
+            }
+        }
+
+        // A finished transfer frees a connection for the next request
+        if (!finished) {
+            // Woken early by release_consumed() and stop_transfer()
+            curl_multi_poll(m_multi_handle, nullptr, 0, kPollTimeoutMs,
+                            nullptr);
+        }
     }
 
-    // Check HTTP response code
-    if (!m_download_error) {
-        long http_code = 0;
-        curl_easy_getinfo(m_curl_handle, CURLINFO_RESPONSE_CODE, &http_code);
-        if (http_code >= 400) {
-            m_download_error = true;
-            m_error_message = "HTTP error: " + std::to_string(http_code);
+    for (const auto &t : m_transfers) {
+        if (t->handle) {
+            curl_multi_remove_handle(m_multi_handle, t->handle);
+            m_idle_handles.push_back(t->handle);
         }
     }
+    {
+        std::lock_guard lock(m_buffer_mutex);
+        m_transfers.clear();
+    }
+
+    if (failed && !m_stop_requested) {
+        m_download_error = true;
+    }
 
     m_download_complete = true;
     m_data_available_cv.notify_all();
@@ -0,0 +1,245 @@
+#include "yapl/detail/data_sources/mapped_file.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace yapl::data_sources {
+
+namespace {
+#ifdef _WIN32
+const uint8_t *map_file(const std::filesystem::path &path, size_t &size) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file: " + path.string());
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to get file size: " + path.string());
+    }
+    size = static_cast<size_t>(file_size.QuadPart);
+    if (size == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    HANDLE mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    return static_cast<const uint8_t *>(view);
+}
+
+void unmap_file(const uint8_t *data, size_t) {
+    UnmapViewOfFile(data);
+}
+
+// FILE_FLAG_SEQUENTIAL_SCAN already drives read-ahead on Windows
+void advise_sequential(const uint8_t *, size_t) {}
+void advise_will_need(const uint8_t *, size_t) {}
+#else
+const uint8_t *map_file(const std::filesystem::path &path, size_t &size) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file: " + path.string());
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + path.string());
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map file: " + path.string());
+    }
+    return static_cast<const uint8_t *>(data);
+}
+
+void unmap_file(const uint8_t *data, size_t size) {
+    munmap(const_cast<uint8_t *>(data), size);
+}
+
+void advise_sequential(const uint8_t *data, size_t size) {
+    madvise(const_cast<uint8_t *>(data), size, MADV_SEQUENTIAL);
+}
+
+// madvise() needs a page-aligned start address
+void advise_will_need(const uint8_t *data, size_t size) {
+    static const auto page_size =
+        static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<uintptr_t>(data);
+    const auto aligned = begin & ~(page_size - 1);
+    madvise(reinterpret_cast<void *>(aligned), size + (begin - aligned),
+            MADV_WILLNEED);
+}
+#endif
+} // namespace
+
+mapped_file::mapped_file(std::filesystem::path file_path)
+    : m_file_path(std::move(file_path)) {}
+
+mapped_file::~mapped_file() { unmap(); }
+
+mapped_file::mapped_file(mapped_file &&other) noexcept
+    : m_file_path{std::move(other.m_file_path)},
+      m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_position{std::exchange(other.m_position, 0)},
+      m_prefetched_until{std::exchange(other.m_prefetched_until, 0)},
+      m_is_open{std::exchange(other.m_is_open, false)} {}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_file_path = std::move(other.m_file_path);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_position = std::exchange(other.m_position, 0);
+        m_prefetched_until = std::exchange(other.m_prefetched_until, 0);
+        m_is_open = std::exchange(other.m_is_open, false);
+    }
+    return *this;
+}
+
+void mapped_file::open() {
+    unmap();
+    m_data = map_file(m_file_path, m_size);
+    m_position = 0;
+    m_prefetched_until = 0;
+    m_is_open = true;
+
+    if (m_data) {
+        advise_sequential(m_data, m_size);
+        read_ahead();
+    }
+}
+
+void mapped_file::close() { unmap(); }
+
+bool mapped_file::is_open() const { return m_is_open; }
+
+size_t mapped_file::read_data(size_t size, std::span<uint8_t> buffer) {
+    if (!m_is_open) {
+        throw std::runtime_error("File is not open: " + m_file_path.string());
+    }
+
+    if (buffer.size() < size) {
+        throw std::invalid_argument("Buffer too small for requested read size");
+    }
+
+    const auto data = consume(size);
+    if (!data.empty()) {
+        std::memcpy(buffer.data(), data.data(), data.size());
+    }
+    return data.size();
+}
+
+size_t mapped_file::available() const { return m_size - m_position; }
+
+void mapped_file::reset() {
+    m_position = 0;
+    m_prefetched_until = 0;
+    if (m_data) {
+        read_ahead();
+    }
+}
+
+bool mapped_file::seek(size_t offset) {
+    if (!m_is_open) {
+        throw std::runtime_error("File is not open: " + m_file_path.string());
+    }
+    if (offset > m_size) {
+        return false;
+    }
+
+    m_position = offset;
+    // Prefetch around the new position rather than the old window
+    m_prefetched_until = offset;
+    read_ahead();
+    return true;
+}
+
+std::optional<size_t> mapped_file::size() const {
+    if (!m_is_open) {
+        return std::nullopt;
+    }
+    return m_size;
+}
+
+std::span<const uint8_t> mapped_file::mapping() const {
+    return {m_data, m_size};
+}
+
+std::span<const uint8_t> mapped_file::consume(size_t size) {
+    if (!m_is_open) {
+        throw std::runtime_error("File is not open: " + m_file_path.string());
+    }
+
+    const size_t count = std::min(size, m_size - m_position);
+    if (count == 0) {
+        return {};
+    }
+
+    std::span<const uint8_t> data{m_data + m_position, count};
+    m_position += count;
+    read_ahead();
+    return data;
+}
+
+void mapped_file::read_ahead() {
+    // Refill once half of the prefetched window has been read
+    if (m_position + kReadAheadBytes / 2 < m_prefetched_until ||
+        m_prefetched_until >= m_size) {
+        return;
+    }
+    const size_t begin = std::max(m_position, m_prefetched_until);
+    const size_t end = std::min(m_size, m_position + kReadAheadBytes);
+    if (begin < end) {
+        advise_will_need(m_data + begin, end - begin);
+    }
+    m_prefetched_until = end;
+}
+
+void mapped_file::unmap() {
+    if (m_data) {
+        unmap_file(m_data, m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    m_prefetched_until = 0;
+    m_is_open = false;
+}
+
+} // namespace yapl::data_sources
@@ -1,10 +1,52 @@
 #include "yapl/detail/decoders/ffmpeg/audio_decoder.hpp"
 #include "yapl/detail/debug.hpp"
-#include "yapl/detail/utilities.hpp"
+#include "yapl/detail/decoders/ffmpeg/packet.hpp"
 #include <fmt/format.h>
 
 namespace yapl::decoders::ffmpeg {
 
+namespace {
+constexpr AVRational kMillisecondTimeBase{1, 1000};
+
+int64_t frame_pts_ms(const AVFrame *frame) {
+    if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+        return frame->best_effort_timestamp;
+    }
+    return frame->pts != AV_NOPTS_VALUE ? frame->pts : 0;
+}
+
+// Interleaves planar float into sample->data, which the caller has sized
+bool write_interleaved_f32(const AVFrame *frame, media_sample &sample) {
+    switch (frame->format) {
+    case AV_SAMPLE_FMT_FLTP: {
+        switch (frame->ch_layout.nb_channels) {
+        case 2: {
+            const float *left = (const float *)frame->extended_data[0];
+            const float *right = (const float *)frame->extended_data[1];
+            float *out = reinterpret_cast<float *>(sample.data.data());
+
+            for (int i = 0; i < frame->nb_samples; i++) {
+                out[i * 2 + 0] = left[i];
+                out[i * 2 + 1] = right[i];
+            }
+        } break;
+        default: {
+            LOG_CRITICAL("Unsuported audio number of channels {}",
+                         frame->ch_layout.nb_channels);
+            return false;
+        }
+        }
+    } break;
+    default:
+        LOG_CRITICAL("Unsuported audio frame format {}",
+                     av_get_sample_fmt_name(
+                         static_cast<AVSampleFormat>(frame->format)));
+        return false;
+    }
+    return true;
+}
+} // namespace
+
 audio_decoder::audio_decoder(AVCodecID codec_id,
                              std::span<uint8_t> extra_data) {
     m_codecpar = avcodec_parameters_alloc();
@@ -30,13 +72,23 @@ audio_decoder::audio_decoder(AVCodecID codec_id,
     memset(m_codec_ctx->extradata + extra_data.size(), 0,
            AV_INPUT_BUFFER_PADDING_SIZE);
     m_codec_ctx->extradata_size = static_cast<int>(extra_data.size());
+    // Packets carry millisecond timestamps, so frames come out in ms too
+    m_codec_ctx->pkt_timebase = kMillisecondTimeBase;
 
     if (avcodec_open2(m_codec_ctx, codec, nullptr) < 0) {
         throw std::runtime_error("Could not open codec");
     }
+
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    if (!m_packet || !m_frame) {
+        throw std::runtime_error("Could not allocate decoder packet/frame");
+    }
 }
 
 audio_decoder::~audio_decoder() {
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
     avcodec_parameters_free(&m_codecpar);
     avcodec_free_context(&m_codec_ctx);
     LOG_TRACE("Audio decoder destroyed");
@@ -44,38 +96,49 @@ audio_decoder::~audio_decoder() {
 
 bool audio_decoder::decode([[maybe_unused]] std::shared_ptr<track_info> info,
                            std::shared_ptr<media_sample> sample,
-                           std::shared_ptr<media_sample> decoded_sample) {
-    AVPacket *packet = av_packet_alloc();
-    AVFrame *frame = av_frame_alloc();
-
-    utilities::raii_cleanup clean{[&] {
-        av_packet_unref(packet);
-        av_packet_free(&packet);
-        av_frame_free(&frame);
-    }};
-
-    if (sample && sample->data.size() > 0) {
-        packet->data = sample->data.data();
-        packet->size = static_cast<int>(sample->data.size());
-
-        int ret = avcodec_send_packet(m_codec_ctx, packet);
+                           const frame_callback &on_frame) {
+    if (sample && load_packet(*sample, m_packet)) {
+        // The long-lived packet only borrows the sample's buffer; unref drops
+        // that reference and leaves it blank for the next call
+        int ret = avcodec_send_packet(m_codec_ctx, m_packet);
+        av_packet_unref(m_packet);
         if (ret < 0) {
             char buffer[1024]{0};
             av_strerror(ret, buffer, 1024);
             LOG_CRITICAL("send_packet error: {}, {}. Sample debug id: {}", ret,
                          buffer, sample->debug_id);
-            av_packet_free(&packet);
             return false;
         }
     } else {
         LOG_WARN("Empty audio frame received");
     }
 
-    static int max_rcvd_frames = -1;
-    auto received_frames = 0;
+    return receive_frames(on_frame);
+}
+
+bool audio_decoder::flush(const frame_callback &on_frame) {
+    int ret = avcodec_send_packet(m_codec_ctx, nullptr);
+    if (ret < 0 && ret != AVERROR_EOF) {
+        char buffer[1024]{0};
+        av_strerror(ret, buffer, 1024);
+        LOG_ERROR("Audio decoder flush error {}", buffer);
+        return false;
+    }
+
+    const bool drained = receive_frames(on_frame);
+    avcodec_flush_buffers(m_codec_ctx);
+    LOG_DEBUG("Audio decoder flushed");
+    return drained;
+}
 
+void audio_decoder::reset() {
+    avcodec_flush_buffers(m_codec_ctx);
+    LOG_DEBUG("Audio decoder reset");
+}
+
+bool audio_decoder::receive_frames(const frame_callback &on_frame) {
     while (true) {
-        int ret = avcodec_receive_frame(m_codec_ctx, frame);
+        int ret = avcodec_receive_frame(m_codec_ctx, m_frame);
         if (ret == AVERROR(EAGAIN)) {
             break; // Need more input
         } else if (ret == AVERROR_EOF) {
@@ -87,40 +150,24 @@ bool audio_decoder::decode([[maybe_unused]] std::shared_ptr<track_info> info,
             return false;
         }
 
-        if (max_rcvd_frames < ++received_frames) {
-            max_rcvd_frames = received_frames;
-            LOG_DEBUG("Max recevide audio frames: {}", received_frames);
-        }
-
-        switch (frame->format) {
-        case AV_SAMPLE_FMT_FLTP: {
-            decoded_sample->data.resize(frame->ch_layout.nb_channels *
-                                        frame->nb_samples * sizeof(float));
-            switch (frame->ch_layout.nb_channels) {
-            case 2: {
-                float *left = (float *)frame->extended_data[0];
-                float *right = (float *)frame->extended_data[1];
-                float *out =
-                    reinterpret_cast<float *>(decoded_sample->data.data());
-
-                for (int i = 0; i < frame->nb_samples; i++) {
-                    out[i * 2 + 0] = left[i];
-                    out[i * 2 + 1] = right[i];
-                }
-            } break;
-            default: {
-                LOG_CRITICAL("Unsuported audio number of channels {}",
-                             frame->ch_layout.nb_channels);
-            } break;
-            }
-        } break;
-        default:
-            LOG_CRITICAL("Unsuported audio frame format {}",
-                         av_get_sample_fmt_name(
-                             static_cast<AVSampleFormat>(frame->format)));
-            break;
+        const auto channels = m_frame->ch_layout.nb_channels;
+        const frame_key key{
+            .format = sample_format::f32_interleaved,
+            .width = static_cast<size_t>(channels),
+            .height = static_cast<size_t>(m_frame->sample_rate)};
+        auto decoded = m_frame_pool.acquire(
+            key, static_cast<size_t>(channels) * m_frame->nb_samples *
+                     sizeof(float));
+        decoded->pts = frame_pts_ms(m_frame);
+        decoded->dts = m_frame->pkt_dts;
+        decoded->duration = static_cast<size_t>(m_frame->duration);
+
+        if (write_interleaved_f32(m_frame, *decoded)) {
+            on_frame(std::move(decoded));
         }
     }
+
+    av_frame_unref(m_frame);
     return true;
 }
 
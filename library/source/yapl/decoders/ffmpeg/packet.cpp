@@ -0,0 +1,61 @@
+#include "yapl/detail/decoders/ffmpeg/packet.hpp"
+
+#include <memory>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#ifdef __cplusplus
+}
+#endif
+
+namespace yapl::decoders::ffmpeg {
+
+static_assert(packet_ref::kPadding >= AV_INPUT_BUFFER_PADDING_SIZE,
+              "packet_ref padding must cover libavcodec's overread");
+
+namespace {
+void release_owner(void *opaque, [[maybe_unused]] uint8_t *data) {
+    delete static_cast<std::shared_ptr<void> *>(opaque);
+}
+} // namespace
+
+bool load_packet(const media_sample &sample, AVPacket *packet) {
+    if (sample.packet.buffer) {
+        // libavcodec may hold the buffer past this call (frame threading);
+        // a second reference to the demuxer's buffer covers that
+        packet->buf = av_buffer_ref(sample.packet.buffer);
+        if (!packet->buf) {
+            return false;
+        }
+        packet->data = const_cast<uint8_t *>(sample.packet.data);
+        packet->size = static_cast<int>(sample.packet.size);
+    } else if (!sample.packet.empty()) {
+        // Memory owned outside libavutil gets an AVBufferRef that carries
+        // its own copy of the owner
+        auto *owner = new std::shared_ptr<void>(sample.packet.owner);
+        packet->buf = av_buffer_create(
+            const_cast<uint8_t *>(sample.packet.data), sample.packet.size,
+            release_owner, owner, AV_BUFFER_FLAG_READONLY);
+        if (!packet->buf) {
+            delete owner;
+            return false;
+        }
+        packet->data = packet->buf->data;
+        packet->size = static_cast<int>(sample.packet.size);
+    } else if (!sample.data.empty()) {
+        packet->data = const_cast<uint8_t *>(sample.data.data());
+        packet->size = static_cast<int>(sample.data.size());
+    } else {
+        return false;
+    }
+
+    packet->pts = sample.pts;
+    packet->dts = sample.dts;
+    packet->duration = static_cast<int64_t>(sample.duration);
+    return true;
+}
+
+} // namespace yapl::decoders::ffmpeg
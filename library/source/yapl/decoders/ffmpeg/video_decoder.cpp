@@ -1,6 +1,6 @@
 #include "yapl/detail/decoders/ffmpeg/video_decoder.hpp"
 #include "yapl/detail/debug.hpp"
-#include "yapl/detail/utilities.hpp"
+#include "yapl/detail/decoders/ffmpeg/packet.hpp"
 #include "yapl/media_sample.hpp"
 #include "yapl/track_info.hpp"
 
@@ -10,6 +10,7 @@
 #include <libavutil/frame.h>
 #include <memory>
 #include <stdexcept>
+#include <string_view>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -18,41 +19,96 @@ extern "C" {
 #include <libavcodec/codec_id.h>
 #include <libavcodec/codec_par.h>
 #include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
 #ifdef __cplusplus
 }
 #endif
 
 namespace yapl::decoders::ffmpeg {
 
-void write_yuv420p_frame(AVFrame *frame, std::shared_ptr<media_sample> sample) {
-    // For YUV420p format
-    if (frame->format == AV_PIX_FMT_YUV420P) {
-        sample->data.resize(frame->width * frame->height * 3 / 2);
-        auto *ptr = sample->data.data();
-        // Write Y plane (luma)
-        for (int y = 0; y < frame->height; y++) {
-            memcpy(ptr, frame->data[0] + y * frame->linesize[0], frame->width);
-            ptr += frame->width;
-        }
+namespace {
+constexpr AVRational kMillisecondTimeBase{1, 1000};
 
-        // Write U plane (chroma)
-        for (int y = 0; y < frame->height / 2; y++) {
-            memcpy(ptr, frame->data[1] + y * frame->linesize[1],
-                   frame->width / 2);
-            ptr += frame->width / 2;
-        }
+void free_frame(void *frame) {
+    auto *av_frame = static_cast<AVFrame *>(frame);
+    av_frame_free(&av_frame);
+}
+
+// Returns the picture buffers to the decoder's pool but keeps the AVFrame
+// shell attached to the recycled sample
+void unref_frame(void *frame) { av_frame_unref(static_cast<AVFrame *>(frame)); }
+
+// The renderers take 8-bit 4:2:0 planes; everything else is converted first
+bool is_yuv420p(int format) {
+    return format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P;
+}
 
-        // Write V plane (chroma)
-        for (int y = 0; y < frame->height / 2; y++) {
-            memcpy(ptr, frame->data[2] + y * frame->linesize[2],
-                   frame->width / 2);
-            ptr += frame->width / 2;
+std::string_view pix_fmt_name(int format) {
+    const char *name = av_get_pix_fmt_name(static_cast<AVPixelFormat>(format));
+    return name ? name : "unknown";
+}
+
+// Hands the decoded picture to the sample without copying: the sample takes
+// over the frame's buffer references and exposes the planes with their native
+// linesizes. The decoder's buffer pool gets the memory back once the last
+// holder of the sample releases it. A recycled sample brings back the AVFrame
+// it held before, so only the first use of each pooled sample allocates one.
+bool attach_yuv420p_frame(AVFrame *frame, media_sample &sample) {
+    auto &planes = sample.planes;
+    if (!planes.owner) {
+        AVFrame *shell = av_frame_alloc();
+        if (!shell) {
+            return false;
         }
+        planes.owner = std::shared_ptr<void>(shell, free_frame);
+        planes.release = unref_frame;
+    }
+
+    auto *owned = static_cast<AVFrame *>(planes.owner.get());
+    av_frame_move_ref(owned, frame);
+    for (size_t i = 0; i < frame_planes::kMaxPlanes; ++i) {
+        planes.data[i] = owned->data[i];
+        planes.linesize[i] = owned->linesize[i];
+    }
+    sample.data.clear();
+    return true;
+}
+
+int to_ffmpeg_thread_type(decoder_thread_type type) {
+    switch (type) {
+    case decoder_thread_type::frame:
+        return FF_THREAD_FRAME;
+    case decoder_thread_type::slice:
+        return FF_THREAD_SLICE;
+    case decoder_thread_type::automatic:
+    default:
+        return FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+}
+
+// Packets carry millisecond timestamps and pkt_timebase is set to match, so
+// frame timestamps come out in milliseconds as well
+int64_t frame_pts_ms(const AVFrame *frame) {
+    if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+        return frame->best_effort_timestamp;
     }
+    return frame->pts != AV_NOPTS_VALUE ? frame->pts : 0;
 }
 
+std::string_view active_thread_type_name(int active_thread_type) {
+    if (active_thread_type & FF_THREAD_FRAME) {
+        return "frame";
+    }
+    if (active_thread_type & FF_THREAD_SLICE) {
+        return "slice";
+    }
+    return "none";
+}
+} // namespace
+
 video_decoder::video_decoder(AVCodecID codec_id,
-                             std::span<uint8_t> extra_data) {
+                             std::span<uint8_t> extra_data,
+                             const decoder_threading &threading) {
     m_codecpar = avcodec_parameters_alloc();
     m_codecpar->codec_id = codec_id;
 
@@ -77,12 +133,35 @@ video_decoder::video_decoder(AVCodecID codec_id,
            AV_INPUT_BUFFER_PADDING_SIZE);
     m_codec_ctx->extradata_size = static_cast<int>(extra_data.size());
 
+    m_codec_ctx->pkt_timebase = kMillisecondTimeBase;
+
+    // Must be set before opening; 0 threads lets libavcodec pick
+    m_codec_ctx->thread_count = static_cast<int>(threading.thread_count);
+    m_codec_ctx->thread_type = to_ffmpeg_thread_type(threading.thread_type);
+
     if (avcodec_open2(m_codec_ctx, codec, nullptr) < 0) {
         throw std::runtime_error("Could not open codec");
     }
+
+    LOG_INFO("Video decoder {}: {} thread(s), {} threading (requested {} x{})",
+             codec->name, m_codec_ctx->thread_count,
+             active_thread_type_name(m_codec_ctx->active_thread_type),
+             decoder_thread_type_to_string(threading.thread_type),
+             threading.thread_count);
+
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    m_converted = av_frame_alloc();
+    if (!m_packet || !m_frame || !m_converted) {
+        throw std::runtime_error("Could not allocate decoder packet/frame");
+    }
 }
 
 video_decoder::~video_decoder() {
+    av_frame_free(&m_converted);
+    av_frame_free(&m_frame);
+    sws_freeContext(m_sws_ctx);
+    av_packet_free(&m_packet);
     avcodec_parameters_free(&m_codecpar);
     avcodec_free_context(&m_codec_ctx);
     LOG_TRACE("Video decoder destroyed");
@@ -90,38 +169,49 @@ video_decoder::~video_decoder() {
 
 bool video_decoder::decode([[maybe_unused]] std::shared_ptr<track_info> info,
                            std::shared_ptr<media_sample> sample,
-                           std::shared_ptr<media_sample> decoded_sample) {
-    AVPacket *packet = av_packet_alloc();
-    AVFrame *frame = av_frame_alloc();
-
-    utilities::raii_cleanup clean{[&] {
-        av_packet_unref(packet);
-        av_packet_free(&packet);
-        av_frame_free(&frame);
-    }};
-
-    if (sample && sample->data.size() > 0) {
-        packet->data = sample->data.data();
-        packet->size = static_cast<int>(sample->data.size());
-
-        int ret = avcodec_send_packet(m_codec_ctx, packet);
+                           const frame_callback &on_frame) {
+    if (sample && load_packet(*sample, m_packet)) {
+        // The long-lived packet only borrows the sample's buffer; unref drops
+        // that reference and leaves it blank for the next call
+        int ret = avcodec_send_packet(m_codec_ctx, m_packet);
+        av_packet_unref(m_packet);
         if (ret < 0) {
             char buffer[1024]{0};
             av_strerror(ret, buffer, 1024);
             LOG_CRITICAL("send_packet error: {}, {}. Sample debug id: {}", ret,
                          buffer, sample->debug_id);
-            av_packet_free(&packet);
             return false;
         }
     } else {
         LOG_DEBUG("Null packet sent to video decoder");
     }
 
-    static int max_rcvd_frames = -1;
-    auto received_frames = 0;
+    return receive_frames(on_frame);
+}
+
+bool video_decoder::flush(const frame_callback &on_frame) {
+    int ret = avcodec_send_packet(m_codec_ctx, nullptr);
+    if (ret < 0 && ret != AVERROR_EOF) {
+        char buffer[1024]{0};
+        av_strerror(ret, buffer, 1024);
+        LOG_ERROR("Video decoder flush error {}", buffer);
+        return false;
+    }
+
+    const bool drained = receive_frames(on_frame);
+    avcodec_flush_buffers(m_codec_ctx);
+    LOG_DEBUG("Video decoder flushed");
+    return drained;
+}
+
+void video_decoder::reset() {
+    avcodec_flush_buffers(m_codec_ctx);
+    LOG_DEBUG("Video decoder reset");
+}
 
+bool video_decoder::receive_frames(const frame_callback &on_frame) {
     while (true) {
-        int ret = avcodec_receive_frame(m_codec_ctx, frame);
+        int ret = avcodec_receive_frame(m_codec_ctx, m_frame);
         if (ret == AVERROR(EAGAIN)) {
             break; // Need more input
         } else if (ret == AVERROR_EOF) {
@@ -133,14 +223,67 @@ bool video_decoder::decode([[maybe_unused]] std::shared_ptr<track_info> info,
             return false;
         }
 
-        if (max_rcvd_frames < ++received_frames) {
-            max_rcvd_frames = received_frames;
-            LOG_DEBUG("Max recevide video frames: {}", received_frames);
+        AVFrame *picture = m_frame;
+        if (!is_yuv420p(m_frame->format)) {
+            picture = convert_to_yuv420p(m_frame);
+            if (!picture) {
+                continue;
+            }
+        }
+
+        const frame_key key{.format = sample_format::yuv420p,
+                            .width = static_cast<size_t>(m_frame->width),
+                            .height = static_cast<size_t>(m_frame->height)};
+        auto decoded = m_frame_pool.acquire(key, 0);
+        decoded->pts = frame_pts_ms(m_frame);
+        decoded->dts = m_frame->pkt_dts;
+        decoded->duration = static_cast<size_t>(m_frame->duration);
+
+        if (attach_yuv420p_frame(picture, *decoded)) {
+            on_frame(std::move(decoded));
         }
-        write_yuv420p_frame(frame, decoded_sample);
     }
 
+    av_frame_unref(m_frame);
     return true;
 }
 
+AVFrame *video_decoder::convert_to_yuv420p(const AVFrame *frame) {
+    // Logged when the source format changes, not for every frame
+    const bool new_format = frame->format != m_converted_from;
+    m_converted_from = frame->format;
+
+    m_sws_ctx = sws_getCachedContext(
+        m_sws_ctx, frame->width, frame->height,
+        static_cast<AVPixelFormat>(frame->format), frame->width,
+        frame->height, AV_PIX_FMT_YUV420P, SWS_BILINEAR, nullptr, nullptr,
+        nullptr);
+    if (!m_sws_ctx) {
+        if (new_format) {
+            LOG_ERROR("Cannot convert {} video frames to yuv420p; dropping "
+                      "them",
+                      pix_fmt_name(frame->format));
+        }
+        return nullptr;
+    }
+    if (new_format) {
+        LOG_INFO("Converting {} video frames to yuv420p",
+                 pix_fmt_name(frame->format));
+    }
+
+    // Not pooled: a fresh buffer per frame, released with the sample
+    av_frame_unref(m_converted);
+    m_converted->format = AV_PIX_FMT_YUV420P;
+    m_converted->width = frame->width;
+    m_converted->height = frame->height;
+    if (av_frame_get_buffer(m_converted, 0) < 0) {
+        LOG_ERROR("Could not allocate converted video frame");
+        return nullptr;
+    }
+    sws_scale(m_sws_ctx, frame->data, frame->linesize, 0, frame->height,
+              m_converted->data, m_converted->linesize);
+    av_frame_copy_props(m_converted, frame);
+    return m_converted;
+}
+
 } // namespace yapl::decoders::ffmpeg
@@ -1,4 +1,5 @@
 #include "yapl/detail/ffmpeg_media_extractor.hpp"
+#include "yapl/detail/annexb.hpp"
 #include "yapl/detail/debug.hpp"
 #include "yapl/i_media_source.hpp"
 #include "yapl/media_info.hpp"
@@ -7,44 +8,122 @@
 #include "yapl/detail/utilities.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <limits>
 #include <libavcodec/packet.h>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace yapl {
 
 namespace {
-constexpr size_t kAvioBufferSize = 4096;
+int av_read_packet(void *opaque, uint8_t *buf, int buf_size) {
+    auto media_source = static_cast<i_media_source *>(opaque);
+    auto read = media_source->read_packet(
+        buf_size, {buf, static_cast<size_t>(buf_size)});
+    if (read == 0) {
+        return AVERROR_EOF;
+    }
+    return static_cast<int>(read);
+}
+
+// Lets libavformat jump around the source, e.g. to an index at the end of
+// the file, instead of reading everything in between
+int64_t av_seek(void *opaque, int64_t offset, int whence) {
+    auto media_source = static_cast<i_media_source *>(opaque);
+    const auto size = media_source->size();
+
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE:
+        return size ? static_cast<int64_t>(*size) : AVERROR(ENOSYS);
+    case SEEK_SET:
+        break;
+    case SEEK_END:
+        if (!size) {
+            return AVERROR(ENOSYS);
+        }
+        offset += static_cast<int64_t>(*size);
+        break;
+    default:
+        // avio_seek() resolves SEEK_CUR itself
+        return AVERROR(EINVAL);
+    }
+
+    if (offset < 0 || !media_source->seek(static_cast<size_t>(offset))) {
+        return AVERROR(EIO);
+    }
+    return offset;
+}
+
+void unref_buffer(void *buffer) {
+    auto *ref = static_cast<AVBufferRef *>(buffer);
+    av_buffer_unref(&ref);
+}
+
+// Hands the demuxed packet to the sample without copying: the sample takes
+// over the packet's buffer reference, which libavformat allocates with
+// decoder padding, and the rest of the packet is unreferenced as usual.
+// Packets that own no buffer are copied.
+void attach_packet(AVPacket &pkt, media_sample &sample) {
+    if (!pkt.buf) {
+        sample.data.assign(pkt.data, pkt.data + pkt.size);
+        return;
+    }
+    AVBufferRef *buffer = std::exchange(pkt.buf, nullptr);
+
+    sample.packet.data = pkt.data;
+    sample.packet.size = static_cast<size_t>(pkt.size);
+    sample.packet.buffer = buffer;
+    sample.packet.owner = std::shared_ptr<void>(buffer, unref_buffer);
+}
+
+video_codec to_video_codec(AVCodecID codec_id) {
+    switch (codec_id) {
+    case AV_CODEC_ID_H264:
+        return video_codec::h264;
+    case AV_CODEC_ID_HEVC:
+        return video_codec::hevc;
+    case AV_CODEC_ID_VP9:
+        return video_codec::vp9;
+    case AV_CODEC_ID_AV1:
+        return video_codec::av1;
+    default:
+        return video_codec::unknown;
+    }
+}
+
+constexpr AVRational kMillisecondTimeBase{1, 1000};
+
+// Probe limits in fast-start mode unless configured explicitly
+constexpr size_t kFastStartProbeSize = 128 * 1024;
+constexpr int64_t kFastStartAnalyzeDurationUs = 500'000;
 } // namespace
 
 ffmpeg_media_extractor::ffmpeg_media_extractor(
-    std::shared_ptr<i_media_source> _media_source)
-    : m_media_source{_media_source}, m_fmt_ctx{nullptr}, m_avio_ctx{nullptr} {
+    std::shared_ptr<i_media_source> _media_source,
+    const extractor_config &config)
+    : m_media_source{_media_source}, m_bitstream{config.bitstream},
+      m_fmt_ctx{nullptr}, m_avio_ctx{nullptr} {
 
     avformat_network_init();
-    auto av_read_packet = [](void *opaque, uint8_t *buf, int buf_size) -> int {
-        auto media_source = static_cast<i_media_source *>(opaque);
-        auto read = media_source->read_packet(
-            buf_size, {buf, static_cast<size_t>(buf_size)});
-        if (read == 0) {
-            return AVERROR_EOF;
-        }
-        return static_cast<int>(read);
-    };
 
-    m_avio_buffer = static_cast<uint8_t *>(av_malloc(kAvioBufferSize));
+    const auto buffer_size = static_cast<int>(config.io_buffer_size);
+    m_avio_buffer = static_cast<uint8_t *>(av_malloc(buffer_size));
     if (!m_avio_buffer) {
         throw std::runtime_error("Could not allocate AVIO buffer");
     }
     m_avio_ctx =
-        avio_alloc_context(m_avio_buffer, kAvioBufferSize, 0, m_media_source.get(),
-                           av_read_packet, nullptr, nullptr);
+        avio_alloc_context(m_avio_buffer, buffer_size, 0, m_media_source.get(),
+                           av_read_packet, nullptr, av_seek);
     if (!m_avio_ctx) {
         throw std::runtime_error("Could not alocate AVIOContext");
     }
@@ -52,14 +131,48 @@ ffmpeg_media_extractor::ffmpeg_media_extractor(
     m_fmt_ctx = avformat_alloc_context();
     m_fmt_ctx->pb = m_avio_ctx;
     m_fmt_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    // probesize also caps format detection (format_probesize), so a small
+    // value keeps avformat_open_input() to the first few reads
+    size_t probe_size = config.probe_size;
+    int64_t analyze_duration = config.max_analyze_duration_us;
+    if (config.fast_start) {
+        probe_size = probe_size ? probe_size : kFastStartProbeSize;
+        analyze_duration =
+            analyze_duration ? analyze_duration : kFastStartAnalyzeDurationUs;
+    }
+    if (probe_size > 0) {
+        m_fmt_ctx->probesize = static_cast<int64_t>(probe_size);
+        m_fmt_ctx->format_probesize = static_cast<int>(
+            std::min<size_t>(probe_size, std::numeric_limits<int>::max()));
+    }
+    if (analyze_duration > 0) {
+        m_fmt_ctx->max_analyze_duration = analyze_duration;
+    }
+    LOG_DEBUG("Media extractor: Probe limits {} bytes, {} us{}",
+              m_fmt_ctx->probesize, m_fmt_ctx->max_analyze_duration,
+              config.fast_start ? " (fast start)" : "");
 }
 
 void ffmpeg_media_extractor::start() {
+    const auto started = std::chrono::steady_clock::now();
     if (avformat_open_input(&m_fmt_ctx, nullptr, nullptr, nullptr) < 0) {
         throw std::runtime_error("Could not open input from buffer");
     }
+    const auto opened = std::chrono::steady_clock::now();
     m_media_info = std::make_shared<media_info>();
     fetch_media_info();
+
+    m_startup_stats.open_input_us = utilities::elapsed_us(started, opened);
+    m_startup_stats.find_stream_info_us =
+        utilities::elapsed_us(opened, std::chrono::steady_clock::now());
+    LOG_DEBUG("Media extractor: Input opened in {} us, stream info in {} us",
+              m_startup_stats.open_input_us,
+              m_startup_stats.find_stream_info_us);
+}
+
+extractor_startup_stats ffmpeg_media_extractor::get_startup_stats() const {
+    return m_startup_stats;
 }
 
 ffmpeg_media_extractor::~ffmpeg_media_extractor() {
@@ -84,6 +197,9 @@ void ffmpeg_media_extractor::fetch_media_info() {
 
     m_media_info->duration = m_fmt_ctx->duration;
     m_media_info->number_of_tracks = m_fmt_ctx->nb_streams;
+    m_nal_length_sizes.assign(m_fmt_ctx->nb_streams, 0);
+    m_keyframe_indexes.assign(m_fmt_ctx->nb_streams, {});
+    m_video_stream = -1;
 
     for (auto i = 0u; i < m_fmt_ctx->nb_streams; ++i) {
         AVStream *stream = m_fmt_ctx->streams[i];
@@ -119,11 +235,28 @@ void ffmpeg_media_extractor::fetch_media_info() {
             video_uniques.height = codecpar->height;
             video_uniques.frame_rate = av_q2d(stream->avg_frame_rate);
             video_uniques.bit_rate = codecpar->bit_rate;
-            video_uniques.extra_data =
-                std::make_shared<video_extra_data>(std::span<uint8_t>{
-                    codecpar->extradata,
-                    codecpar->extradata + codecpar->extradata_size});
-
+            video_uniques.extra_data = std::make_shared<video_extra_data>(
+                to_video_codec(codecpar->codec_id),
+                std::span<const uint8_t>{codecpar->extradata,
+                                         static_cast<size_t>(
+                                             codecpar->extradata_size)});
+
+            // Only length-prefixed NAL units (H.264/HEVC from MP4/MKV) are
+            // converted; VP9 and AV1 have no start-code form
+            const auto nal_size_length =
+                video_uniques.extra_data->nal_size_length;
+            if (m_bitstream == video_bitstream::annexb && nal_size_length) {
+                m_nal_length_sizes[i] = nal_size_length;
+                video_uniques.bitstream = video_bitstream::annexb;
+            }
+            seed_keyframe_index(i);
+            if (m_video_stream < 0) {
+                m_video_stream = static_cast<int>(i);
+            }
+            LOG_DEBUG("Media extractor: Video stream {} ({}) samples {}", i,
+                      video_codec_to_string(
+                          video_uniques.extra_data->codec),
+                      video_bitstream_to_string(video_uniques.bitstream));
             _track.video =
                 std::make_shared<video_track_uniques>(std::move(video_uniques));
             m_media_info->tracks.push_back(
@@ -143,87 +276,46 @@ void ffmpeg_media_extractor::fetch_media_info() {
     }
 }
 
-enum class nal_unit_type {
-    unspecified = 0,
-    coded_sliece = 1, // non-keyframe
-    data_partition_a = 2,
-    data_partition_b = 3,
-    data_partition_c = 4,
-    idr_slice = 5, // keyframe
-    sei = 6,
-    sps = 7,
-    pps = 8,
-    aud = 9,
-    end_of_sequence = 10,
-    end_of_stream = 11,
-    filter_data = 12, // padding
-};
-
-std::string to_string(nal_unit_type frame) {
-    switch (frame) {
-    default:
-    case nal_unit_type::unspecified:
-        return "Unspecified";
-    case nal_unit_type::coded_sliece:
-        return "Coded Sliece";
-    case nal_unit_type::data_partition_a:
-        return "Data Partition a";
-    case nal_unit_type::data_partition_b:
-        return "Data Partition b";
-    case nal_unit_type::data_partition_c:
-        return "Data Partition c";
-    case nal_unit_type::idr_slice:
-        return "IDR Slice";
-    case nal_unit_type::sei:
-        return "Supplemental Enhancement Information (SEI)";
-    case nal_unit_type::sps:
-        return "Sequence Parameter Set (SPS)";
-    case nal_unit_type::pps:
-        return "Picture Parameter Set (PPS)";
-    case nal_unit_type::aud:
-        return "Access Unit Delimiter (AUD)";
-    case nal_unit_type::end_of_sequence:
-        return "End Of Sequence";
-    case nal_unit_type::end_of_stream:
-        return "End Of Stream";
-    case nal_unit_type::filter_data:
-        return "Filter Data";
+void ffmpeg_media_extractor::seed_keyframe_index(size_t stream_id) {
+    AVStream *stream = m_fmt_ctx->streams[stream_id];
+    std::lock_guard lock{m_keyframe_mutex};
+    auto &index = m_keyframe_indexes[stream_id];
+
+    // MP4 indexes every sample and Matroska its cues; only keyframes are
+    // kept. MP4 index timestamps are decode times, while the index and its
+    // callers work in presentation time like the demuxed samples. Keyframes
+    // are shown after the same reordering delay throughout a stream, so the
+    // first frame's pts - dts converts all of them (0 for Matroska cues).
+    const int count = avformat_index_get_entries_count(stream);
+    const AVIndexEntry *first = avformat_index_get_entry(stream, 0);
+    const int64_t pts_offset =
+        first && stream->start_time != AV_NOPTS_VALUE
+            ? std::max<int64_t>(stream->start_time - first->timestamp, 0)
+            : 0;
+    for (int i = 0; i < count; ++i) {
+        const AVIndexEntry *entry = avformat_index_get_entry(stream, i);
+        if (!(entry->flags & AVINDEX_KEYFRAME)) {
+            continue;
+        }
+        index.add({.pts_ms = av_rescale_q(entry->timestamp + pts_offset,
+                                          stream->time_base,
+                                          kMillisecondTimeBase),
+                   .byte_offset = entry->pos,
+                   .size = static_cast<uint32_t>(entry->size)});
     }
+    index.set_from_container(!index.empty());
+    LOG_DEBUG("Media extractor: Stream {} keyframe index {} entries ({})",
+              stream_id, index.size(),
+              index.from_container() ? "container" : "built while demuxing");
 }
 
-struct avcc_frame {
-    avcc_frame(size_t nal_size_len, std::span<uint8_t> raw_data) {
-        auto pos = 0;
-        for (size_t i = 0; i < nal_size_len; ++i) {
-            size = (size << 8) | raw_data[pos++];
-        }
-        header.value = raw_data[pos];
-        auto begin = raw_data.begin() + pos;
-        auto end = raw_data.begin() + pos + size;
-        data = {begin, end};
-    }
-    uint32_t size;
-    union {
-        struct {
-            nal_unit_type type : 5;
-            uint8_t ref_idc : 2;
-            uint8_t header : 1;
-        } fields;
-        uint8_t value;
-    } header;
-    std::span<uint8_t> data;
-};
-
-size_t ffmpeg_media_extractor::get_nal_header_len() const {
-    auto video_track = std::ranges::find_if(
-        m_media_info->tracks, [](const std::shared_ptr<track_info> _info) {
-            return _info->type == track_type::video;
-        });
-    if (video_track == m_media_info->tracks.end()) {
-        LOG_CRITICAL("Video track is not detected!");
-        throw std::runtime_error{"Video track is not detected!"};
-    }
-    return video_track->get()->video.value()->extra_data->nal_size_length;
+keyframe_index
+ffmpeg_media_extractor::get_keyframe_index(size_t track_id) const {
+    std::lock_guard lock{m_keyframe_mutex};
+    if (track_id >= m_keyframe_indexes.size()) {
+        return {};
+    }
+    return m_keyframe_indexes[track_id];
 }
 
 read_sample_result ffmpeg_media_extractor::read_sample() {
@@ -275,12 +367,31 @@ read_sample_result ffmpeg_media_extractor::read_sample() {
         static_cast<int64_t>(m_pkt.pts * time_base.num * 1000 / time_base.den);
     sample->dts =
         static_cast<int64_t>(m_pkt.dts * time_base.num * 1000 / time_base.den);
-    sample->duration = m_pkt.duration;
-    if (m_fmt_ctx->streams[m_pkt.stream_index]->codecpar->codec_type ==
-        AVMEDIA_TYPE_VIDEO) {
-        packet_to_annexb(get_nal_header_len(), m_pkt, sample);
+    // Decoders and renderers work in milliseconds, like pts/dts above
+    sample->duration = static_cast<size_t>(std::max<int64_t>(
+        av_rescale_q(m_pkt.duration, time_base, kMillisecondTimeBase), 0));
+    sample->keyframe = m_pkt.flags & AV_PKT_FLAG_KEY;
+    if (sample->keyframe && stream_id < m_keyframe_indexes.size() &&
+        m_fmt_ctx->streams[stream_id]->codecpar->codec_type ==
+            AVMEDIA_TYPE_VIDEO &&
+        !m_keyframe_indexes[stream_id].from_container()) {
+        std::lock_guard lock{m_keyframe_mutex};
+        m_keyframe_indexes[stream_id].add(
+            {.pts_ms = sample->pts,
+             .byte_offset = m_pkt.pos,
+             .size = static_cast<uint32_t>(m_pkt.size)});
+    }
+    // Streams FFmpeg found after start() have no cached prefix size and are
+    // forwarded as demuxed
+    const auto nal_length_size = stream_id < m_nal_length_sizes.size()
+                                     ? m_nal_length_sizes[stream_id]
+                                     : uint8_t{0};
+    if (nal_length_size != 0) {
+        packet_to_annexb(nal_length_size,
+                         {m_pkt.data, static_cast<size_t>(m_pkt.size)},
+                         *sample);
     } else {
-        sample->data.assign(m_pkt.data, m_pkt.data + m_pkt.size);
+        attach_packet(m_pkt, *sample);
     }
 
     return {.stream_id = stream_id,
@@ -288,9 +399,63 @@ read_sample_result ffmpeg_media_extractor::read_sample() {
             .sample = sample};
 }
 
+bool ffmpeg_media_extractor::seek(int64_t position_ms) {
+    if (seek_indexed_keyframe(position_ms)) {
+        return true;
+    }
+
+    // Stream index -1 takes the target in AV_TIME_BASE units
+    const int64_t target = av_rescale(position_ms, AV_TIME_BASE, 1000);
+    const int ret =
+        av_seek_frame(m_fmt_ctx, -1, target, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        char buffer[1024]{0};
+        av_strerror(ret, buffer, 1024);
+        LOG_ERROR("Media extractor: Seek to {}ms failed: {}", position_ms,
+                  buffer);
+        return false;
+    }
+    LOG_DEBUG("Media extractor: Seeked to {}ms", position_ms);
+    return true;
+}
+
+bool ffmpeg_media_extractor::seek_indexed_keyframe(int64_t position_ms) {
+    if (m_video_stream < 0 ||
+        (m_fmt_ctx->iformat->flags & AVFMT_NO_BYTE_SEEK)) {
+        return false;
+    }
+    std::optional<keyframe_entry> entry;
+    {
+        std::lock_guard lock{m_keyframe_mutex};
+        const auto &index = m_keyframe_indexes[m_video_stream];
+        // With a container index libavformat already seeks straight to the
+        // GOP. Without one (MPEG-TS, elementary streams) it has to search
+        // the file; a keyframe seen during playback is a known GOP start,
+        // as long as a later keyframe shows the GOP spans position_ms.
+        if (index.from_container() || !index.after(position_ms)) {
+            return false;
+        }
+        entry = index.at_or_before(position_ms);
+    }
+    if (!entry || entry->byte_offset < 0) {
+        return false;
+    }
+
+    const int ret = av_seek_frame(m_fmt_ctx, m_video_stream,
+                                  entry->byte_offset, AVSEEK_FLAG_BYTE);
+    if (ret < 0) {
+        LOG_DEBUG("Media extractor: Byte seek to {} failed, searching instead",
+                  entry->byte_offset);
+        return false;
+    }
+    LOG_DEBUG("Media extractor: Seeked to {}ms via keyframe at {}ms (byte {})",
+              position_ms, entry->pts_ms, entry->byte_offset);
+    return true;
+}
+
 ffmpeg_media_extractor::packet_format
 ffmpeg_media_extractor::determine_packet_format(
-    size_t nal_size_len, const std::span<uint8_t> packet) {
+    size_t nal_size_len, std::span<const uint8_t> packet) {
     if (packet.size() < 4)
         return packet_format::raw_nal_payload;
 
@@ -318,49 +483,45 @@ ffmpeg_media_extractor::determine_packet_format(
     return packet_format::unknown;
 }
 
-void ffmpeg_media_extractor::packet_to_annexb(
-    size_t nal_size_length, AVPacket &pkt,
-    std::shared_ptr<media_sample> &sample) {
-
-    const auto fmt = determine_packet_format(nal_size_length,
-                                             {pkt.data, pkt.data + pkt.size});
-    auto *position = pkt.data;
-    const auto *end = pkt.data + pkt.size;
-
+void ffmpeg_media_extractor::packet_to_annexb(size_t nal_size_length,
+                                              std::span<const uint8_t> packet,
+                                              media_sample &sample) {
     static const uint8_t sc4[4] = {0, 0, 0, 1};
-    switch (fmt) {
+    auto &data = sample.data;
+
+    switch (determine_packet_format(nal_size_length, packet)) {
     case packet_format::annexb:
-        sample->data.assign(pkt.data, pkt.data + pkt.size);
+        data.assign(packet.begin(), packet.end());
         return;
 
     case packet_format::raw_nal_payload:
-        sample->data.insert(sample->data.end(), sc4, sc4 + 4);
-        sample->data.insert(sample->data.end(), pkt.data, pkt.data + pkt.size);
+        data.reserve(sizeof(sc4) + packet.size());
+        data.assign(sc4, sc4 + sizeof(sc4));
+        data.insert(data.end(), packet.begin(), packet.end());
         return;
 
-    case packet_format::avcc:
-        while (position + nal_size_length <= end) {
-            avcc_frame frame{nal_size_length, {position, pkt.data + pkt.size}};
-
-            if (frame.size == 0 ||
-                frame.header.fields.type == nal_unit_type::unspecified) {
-                LOG_TRACE("NAL unit: size={}, type={}", frame.size,
-                          to_string(frame.header.fields.type));
-            }
-            if (frame.header.fields.type == nal_unit_type::end_of_stream) {
-                LOG_DEBUG("Media extractor: NAL EOS detected");
+    case packet_format::avcc: {
+        // Start codes replace 4-byte prefixes one for one: a single copy,
+        // then the prefixes are overwritten
+        if (nal_size_length == sizeof(sc4)) {
+            data.assign(packet.begin(), packet.end());
+            if (const auto size = avcc_to_annexb_in_place(data)) {
+                data.resize(*size);
+                return;
             }
-
-            sample->data.insert(sample->data.end(), sc4, sc4 + 4);
-            sample->data.insert(sample->data.end(), frame.data.begin(),
-                                frame.data.end());
-
-            position += nal_size_length + frame.size;
+        } else if (const auto size =
+                       avcc_to_annexb_size(packet, nal_size_length)) {
+            data.resize(*size);
+            avcc_to_annexb(packet, nal_size_length, data);
+            return;
         }
+        data.clear();
+        LOG_ERROR("Malformed AVCC packet! Packet size {}", packet.size());
         return;
+    }
 
     default:
-        LOG_ERROR("Unknown packet format! Packet size {}", pkt.size);
+        LOG_ERROR("Unknown packet format! Packet size {}", packet.size());
         return;
     }
 }
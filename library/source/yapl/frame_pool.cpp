@@ -0,0 +1,173 @@
+#include "yapl/detail/frame_pool.hpp"
+
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace yapl {
+
+struct frame_pool::state {
+    explicit state(size_t max_free) : max_free_frames{max_free} {
+        free_frames.reserve(max_free_frames);
+        free_blocks.reserve(max_free_frames);
+    }
+
+    ~state() {
+        for (auto *frame : free_frames) {
+            delete frame;
+        }
+        for (auto *block : free_blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    // Returns frames to the free list when the last reference drops
+    struct recycler {
+        std::shared_ptr<state> pool;
+        frame_key key;
+
+        void operator()(media_sample *frame) const {
+            pool->recycle(frame, key);
+        }
+    };
+
+    // Recycles shared_ptr control blocks. Every block has the same type, so a
+    // single free list of equally sized blocks is enough.
+    template <typename T> struct block_allocator {
+        using value_type = T;
+
+        explicit block_allocator(std::shared_ptr<state> p)
+            : pool{std::move(p)} {}
+
+        template <typename U>
+        block_allocator(const block_allocator<U> &other) : pool{other.pool} {}
+
+        T *allocate(size_t n) {
+            return static_cast<T *>(pool->allocate_block(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, size_t n) {
+            pool->release_block(p, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const block_allocator<U> &other) const {
+            return pool == other.pool;
+        }
+
+        std::shared_ptr<state> pool;
+    };
+
+    void recycle(media_sample *frame, const frame_key &key) {
+        // Referenced decoder memory goes back to its owner right away; a
+        // reusable owner stays with the sample for the next frame
+        auto &planes = frame->planes;
+        if (planes.release && planes.owner) {
+            planes.release(planes.owner.get());
+        } else {
+            planes.owner.reset();
+            planes.release = nullptr;
+        }
+        planes.data = {};
+        planes.linesize = {};
+        {
+            std::lock_guard lock(mutex);
+            if (key == current_key && free_frames.size() < max_free_frames) {
+                free_frames.push_back(frame);
+                return;
+            }
+        }
+        delete frame;
+    }
+
+    void *allocate_block(size_t size) {
+        {
+            std::lock_guard lock(mutex);
+            if (size == block_size && !free_blocks.empty()) {
+                auto *block = free_blocks.back();
+                free_blocks.pop_back();
+                return block;
+            }
+            block_size = size;
+        }
+        return ::operator new(size);
+    }
+
+    void release_block(void *block, size_t size) {
+        {
+            std::lock_guard lock(mutex);
+            if (size == block_size && free_blocks.size() < max_free_frames) {
+                free_blocks.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+
+    mutable std::mutex mutex;
+    const size_t max_free_frames;
+    frame_key current_key;
+    std::vector<media_sample *> free_frames;
+    std::vector<void *> free_blocks;
+    size_t block_size{0};
+    size_t allocations{0};
+    size_t reuses{0};
+};
+
+frame_pool::frame_pool(size_t max_free_frames)
+    : m_state{std::make_shared<state>(max_free_frames)} {}
+
+frame_pool::~frame_pool() = default;
+
+std::shared_ptr<media_sample> frame_pool::acquire(const frame_key &key,
+                                                  size_t size_bytes) {
+    media_sample *frame = nullptr;
+    std::vector<media_sample *> stale;
+    {
+        std::lock_guard lock(m_state->mutex);
+        if (!(key == m_state->current_key)) {
+            stale.swap(m_state->free_frames);
+            m_state->free_frames.reserve(m_state->max_free_frames);
+            m_state->current_key = key;
+        }
+        if (!m_state->free_frames.empty()) {
+            frame = m_state->free_frames.back();
+            m_state->free_frames.pop_back();
+            ++m_state->reuses;
+        } else {
+            ++m_state->allocations;
+        }
+    }
+
+    for (auto *old_frame : stale) {
+        delete old_frame;
+    }
+
+    if (!frame) {
+        frame = new media_sample{};
+    } else {
+        frame->debug_id = 0;
+        frame->track_id = 0;
+        frame->pts = 0;
+        frame->dts = 0;
+        frame->duration = 0;
+    }
+
+    if (size_bytes != 0 && frame->data.size() != size_bytes) {
+        frame->data.resize(size_bytes);
+    }
+
+    return std::shared_ptr<media_sample>(
+        frame, state::recycler{m_state, key},
+        state::block_allocator<media_sample>{m_state});
+}
+
+frame_pool_stats frame_pool::stats() const {
+    std::lock_guard lock(m_state->mutex);
+    return {.allocations = m_state->allocations,
+            .reuses = m_state->reuses,
+            .free_frames = m_state->free_frames.size()};
+}
+
+} // namespace yapl
@@ -1,18 +1,37 @@
 #include "yapl/detail/media_pipeline.hpp"
 #include "yapl/detail/debug.hpp"
+#include "yapl/detail/utilities.hpp"
 #include "yapl/media_info.hpp"
 #include "yapl/track.hpp"
 #include "yapl/track_info.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
 
 using namespace std::chrono_literals;
 
 namespace yapl {
 
 namespace {
-constexpr auto kThreadSleep = 1ms;
-constexpr auto kRenderSleep = 5ms;
+// Upper bound on how long the render loop sleeps: keeps input responsive and
+// tops up the audio device well before its ~100ms buffer runs dry.
+constexpr auto kMaxRenderWait = 10ms;
+
+// Free-running clock: how long to wait for the decoder when no frame is
+// pending, and how far to step the clock when no video frame paces it
+constexpr auto kFreeRunIdleWait = 1ms;
+
+// With fast start the demuxer decides how much data it needs
+source_config media_source_config(const pipeline_config &config) {
+    auto source = config.source;
+    if (config.extractor.fast_start) {
+        source.http_buffer_min_kb = 0;
+    }
+    return source;
+}
 } // namespace
 
 media_pipeline::media_pipeline(
@@ -27,12 +46,17 @@ media_pipeline::media_pipeline(
       m_media_extractor_factory{std::move(mef)},
       m_decoder_factory{std::move(df)},
       m_config{std::move(config)},
-      m_media_source{m_media_source_factory->create()},
-      m_media_extractor{m_media_extractor_factory->create(m_media_source)},
+      m_media_clock{m_config.playback_clock},
+      m_media_source{
+          m_media_source_factory->create(media_source_config(m_config))},
+      m_media_extractor{m_media_extractor_factory->create(
+          m_media_source, m_config.extractor)},
       m_video_render{vrf->create_video_renderer(m_media_clock,
-                                                 m_config.video_queue_size)},
+                                                 m_config.video_queue_size,
+                                                 m_config.video_queue_kind)},
       m_audio_render{arf->create_audio_renderer(m_media_clock,
-                                                 m_config.audio_queue_size)},
+                                                 m_config.audio_queue_size,
+                                                 m_config.audio_queue_kind)},
       m_input_handler{ihf->create()} {}
 
 media_pipeline::~media_pipeline() {
@@ -43,40 +67,89 @@ media_pipeline::~media_pipeline() {
 void media_pipeline::load(std::string_view url) {
     LOG_INFO("Loading media: {}", std::string(url));
 
+    using clock = std::chrono::steady_clock;
+    const auto load_started = clock::now();
+    startup_stats startup;
+    {
+        std::lock_guard lock{m_stats_mutex};
+        m_startup = {};
+        m_load_started = load_started;
+        m_duration_ms = 0;
+        m_tracks.clear();
+        m_video_track = nullptr;
+        m_audio_track = nullptr;
+    }
+
     m_media_source->open(url);
+    startup.source_open_us = utilities::elapsed_us(load_started, clock::now());
     m_media_extractor->start();
+    startup.extractor = m_media_extractor->get_startup_stats();
 
     auto media_info = m_media_extractor->get_media_info();
 
-    m_tracks.clear();
-    m_video_track = nullptr;
-    m_audio_track = nullptr;
+    m_video_frames_decoded = 0;
+    m_video_decode_ns = 0;
+    m_demux_latency.reset();
+    m_decode_latency.reset();
+    m_discard_before_ms = std::numeric_limits<int64_t>::min();
+    m_rebase_on_first_frame = false;
+    m_video_at_eos = false;
+    m_audio_at_eos = false;
 
     for (const auto &track_info : media_info->tracks) {
         LOG_DEBUG("Track ID: {}, Type: {}", track_info->track_id,
                   track_type_to_string(track_info->type));
 
-        auto new_track = std::make_shared<track>(track_info);
-        m_tracks.emplace_back(new_track);
+        auto new_track = std::make_shared<track>(
+            track_info, m_config.track_queue_size, m_config.track_queue_kind);
+        const bool first_video =
+            track_info->type == track_type::video && !m_video_track;
+        const bool first_audio =
+            track_info->type == track_type::audio && !m_audio_track;
+        {
+            std::lock_guard lock{m_stats_mutex};
+            m_tracks.emplace_back(new_track);
+            if (first_video) {
+                m_video_track = new_track;
+            }
+            if (first_audio) {
+                m_audio_track = new_track;
+            }
+        }
 
-        if (track_info->type == track_type::video && !m_video_track) {
-            m_video_track = new_track;
+        if (first_video) {
+            const auto decoder_started = clock::now();
+            auto decoder_config =
+                track_info->video.value()->get_decoder_config();
             m_video_decoder = m_decoder_factory->create_video_decoder(
-                track_info->codec_id,
-                track_info->video.value()->extra_data->raw_data);
+                track_info->codec_id, decoder_config,
+                m_config.video_decoder_threading);
+            const auto decoder_opened = clock::now();
+            startup.decoder_open_us +=
+                utilities::elapsed_us(decoder_started, decoder_opened);
             m_video_render->resize(track_info->video.value()->width,
                                    track_info->video.value()->height);
+            startup.renderer_setup_us =
+                utilities::elapsed_us(decoder_opened, clock::now());
         }
 
-        if (track_info->type == track_type::audio && !m_audio_track) {
-            m_audio_track = new_track;
+        if (first_audio) {
+            const auto decoder_started = clock::now();
             m_audio_decoder = m_decoder_factory->create_audio_decoder(
                 track_info->codec_id,
                 track_info->audio.value()->extra_data->data);
+            startup.decoder_open_us +=
+                utilities::elapsed_us(decoder_started, clock::now());
         }
     }
 
-    LOG_INFO("Media loaded successfully");
+    startup.load_us = utilities::elapsed_us(load_started, clock::now());
+    {
+        std::lock_guard lock{m_stats_mutex};
+        m_startup = startup;
+        m_duration_ms = static_cast<int64_t>(media_info->duration / 1000);
+    }
+    LOG_INFO("Media loaded successfully in {} us", startup.load_us);
 }
 
 void media_pipeline::play() {
@@ -84,18 +157,44 @@ void media_pipeline::play() {
     m_running = true;
     m_paused = false;
 
-    m_buffering_thread = std::jthread([this](std::stop_token st) {
-        LOG_DEBUG("Buffering thread started");
-        while (!st.stop_requested()) {
-            if (m_paused) {
-                std::this_thread::sleep_for(kThreadSleep);
-                continue;
+    start_workers();
+
+    while (m_running) {
+        m_input_handler->poll();
+
+        if (!m_paused) {
+            m_video_render->render();
+            m_audio_render->render();
+        }
+        if (m_config.playback_clock == clock_mode::free_running &&
+            !m_paused) {
+            if (!advance_clock()) {
+                std::this_thread::sleep_for(kFreeRunIdleWait);
             }
+            continue;
+        }
+        std::this_thread::sleep_for(next_render_wait());
+    }
+}
 
+void media_pipeline::start_workers() {
+    m_video_at_eos = false;
+    m_audio_at_eos = false;
+    m_buffering_thread = std::jthread([this](std::stop_token st) {
+        LOG_DEBUG("Buffering thread started");
+        while (wait_while_paused(st)) {
+            const auto read_start = std::chrono::steady_clock::now();
             auto result = m_media_extractor->read_sample();
+            m_demux_latency.record(std::chrono::steady_clock::now() -
+                                   read_start);
             if (result.error == read_sample_error_t::no_errror) {
                 if (result.stream_id < m_tracks.size()) {
-                    m_tracks[result.stream_id]->push_sample(result.sample);
+                    // Only feed tracks with a decoder draining them: pushes
+                    // block when a queue is full
+                    auto &target = m_tracks[result.stream_id];
+                    if (target == m_video_track || target == m_audio_track) {
+                        target->push_sample(result.sample);
+                    }
                 }
             } else if (result.error == read_sample_error_t::end_of_stream) {
                 LOG_DEBUG("Buffering: EOS reached");
@@ -104,7 +203,6 @@ void media_pipeline::play() {
                 }
                 break;
             }
-            std::this_thread::sleep_for(kThreadSleep);
         }
         LOG_DEBUG("Buffering thread exiting");
     });
@@ -112,28 +210,53 @@ void media_pipeline::play() {
     if (m_video_track) {
         m_video_decoder_thread = std::jthread([this](std::stop_token st) {
             LOG_DEBUG("Video decoder thread started");
-            while (!st.stop_requested()) {
-                if (m_paused) {
-                    std::this_thread::sleep_for(kThreadSleep);
-                    continue;
+            const auto on_frame = [this](std::shared_ptr<media_sample> frame) {
+                m_video_frames_decoded.fetch_add(1, std::memory_order_relaxed);
+                if (accept_frame(*frame, true)) {
+                    m_video_render->push_frame(std::move(frame));
                 }
-
+            };
+            // Set once keyframes-only decoding dropped reference frames, so
+            // normal decoding restarts at a keyframe
+            bool need_keyframe = false;
+            while (wait_while_paused(st)) {
                 auto result = m_video_track->pop_sample();
                 if (result.error == read_sample_error_t::no_errror) {
-                    auto decoded = std::make_shared<media_sample>();
-                    decoded->duration = result.sample->duration;
-                    decoded->pts = result.sample->pts;
-                    decoded->dts = result.sample->dts;
+                    const bool keyframes_only =
+                        m_keyframes_only.load(std::memory_order_relaxed);
+                    if (!result.sample->keyframe &&
+                        (keyframes_only || need_keyframe)) {
+                        need_keyframe = true;
+                        continue;
+                    }
+                    need_keyframe = false;
+                    const auto decode_start = std::chrono::steady_clock::now();
                     m_video_decoder->decode(m_video_track->get_info(),
-                                            result.sample, decoded);
-                    if (!decoded->data.empty()) {
-                        m_video_render->push_frame(decoded);
+                                            result.sample, on_frame);
+                    if (keyframes_only) {
+                        // No later packet will push a frame-threaded
+                        // decoder's output out, so drain it now
+                        m_video_decoder->flush(on_frame);
                     }
+                    const auto decode_time =
+                        std::chrono::steady_clock::now() - decode_start;
+                    m_decode_latency.record(decode_time);
+                    m_video_decode_ns.fetch_add(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            decode_time)
+                            .count(),
+                        std::memory_order_relaxed);
                 } else if (result.error == read_sample_error_t::end_of_stream) {
+                    // A shut down track reads as EOS too; only drain the
+                    // decoder at the real end of the stream
+                    if (st.stop_requested()) {
+                        break;
+                    }
                     LOG_DEBUG("Video decoder: EOS reached");
+                    m_video_decoder->flush(on_frame);
+                    m_video_at_eos = true;
                     break;
                 }
-                std::this_thread::sleep_for(kThreadSleep);
             }
             LOG_DEBUG("Video decoder thread exiting");
         });
@@ -142,45 +265,216 @@ void media_pipeline::play() {
     if (m_audio_track) {
         m_audio_decoder_thread = std::jthread([this](std::stop_token st) {
             LOG_DEBUG("Audio decoder thread started");
-            while (!st.stop_requested()) {
-                if (m_paused) {
-                    std::this_thread::sleep_for(kThreadSleep);
-                    continue;
+            const auto on_frame = [this](std::shared_ptr<media_sample> frame) {
+                if (accept_frame(*frame, !m_video_track)) {
+                    m_audio_render->push_frame(std::move(frame));
                 }
-
+            };
+            while (wait_while_paused(st)) {
                 auto result = m_audio_track->pop_sample();
                 if (result.error == read_sample_error_t::no_errror) {
-                    auto decoded = std::make_shared<media_sample>();
-                    decoded->duration = result.sample->duration;
-                    decoded->pts = result.sample->pts;
-                    decoded->dts = result.sample->dts;
                     m_audio_decoder->decode(m_audio_track->get_info(),
-                                            result.sample, decoded);
-                    m_audio_render->push_frame(decoded);
+                                            result.sample, on_frame);
                 } else if (result.error == read_sample_error_t::end_of_stream) {
+                    if (st.stop_requested()) {
+                        break;
+                    }
                     LOG_DEBUG("Audio decoder: EOS reached");
+                    m_audio_decoder->flush(on_frame);
+                    m_audio_at_eos = true;
                     break;
                 }
-                std::this_thread::sleep_for(kThreadSleep);
             }
             LOG_DEBUG("Audio decoder thread exiting");
         });
     }
+}
 
-    while (m_running) {
-        m_input_handler->poll();
+void media_pipeline::stop_workers() {
+    m_buffering_thread.request_stop();
+    m_video_decoder_thread.request_stop();
+    m_audio_decoder_thread.request_stop();
 
-        if (!m_paused) {
-            m_video_render->render();
-            m_audio_render->render();
+    // Wakes the buffering thread blocked on a full track and the decoders
+    // blocked on an empty one
+    for (auto &t : m_tracks) {
+        t->shutdown();
+    }
+    // Decoders may also be blocked on a full renderer queue
+    flush_renderers();
+
+    for (auto *worker : {&m_buffering_thread, &m_video_decoder_thread,
+                         &m_audio_decoder_thread}) {
+        if (worker->joinable()) {
+            worker->join();
         }
-        std::this_thread::sleep_for(kRenderSleep);
     }
+
+    // Frames pushed while the decoders were winding down
+    flush_renderers();
+}
+
+void media_pipeline::flush_renderers() {
+    if (m_video_render)
+        m_video_render->flush();
+    if (m_audio_render)
+        m_audio_render->flush();
+}
+
+bool media_pipeline::seek(int64_t position_ms, seek_mode mode) {
+    LOG_DEBUG("Seeking to {}ms ({})", position_ms, seek_mode_to_string(mode));
+
+    const bool restart = m_running;
+    stop_workers();
+
+    const bool repositioned = m_media_extractor->seek(position_ms);
+
+    // Shut down queues can't be reopened: start over with fresh tracks
+    std::unique_lock stats_lock{m_stats_mutex};
+    for (auto &t : m_tracks) {
+        auto fresh = std::make_shared<track>(t->get_info(),
+                                             m_config.track_queue_size,
+                                             m_config.track_queue_kind);
+        if (t == m_video_track) {
+            m_video_track = fresh;
+        }
+        if (t == m_audio_track) {
+            m_audio_track = fresh;
+        }
+        t = std::move(fresh);
+    }
+    stats_lock.unlock();
+
+    if (m_video_decoder)
+        m_video_decoder->reset();
+    if (m_audio_decoder)
+        m_audio_decoder->reset();
+
+    // Decoding restarts at a keyframe before the target. Accurate mode
+    // discards frames up to the target; either way the clock then moves to
+    // the first frame actually shown, which also resynchronizes it when the
+    // extractor could not seek.
+    m_discard_before_ms = mode == seek_mode::accurate
+                              ? position_ms
+                              : std::numeric_limits<int64_t>::min();
+    m_rebase_on_first_frame = true;
+    m_media_clock.rebase(position_ms);
+
+    if (restart) {
+        start_workers();
+    }
+    return repositioned;
+}
+
+void media_pipeline::set_keyframes_only(bool enabled) {
+    LOG_DEBUG("Keyframes-only decoding {}", enabled ? "on" : "off");
+    m_keyframes_only = enabled;
+}
+
+bool media_pipeline::is_keyframes_only() const { return m_keyframes_only; }
+
+bool media_pipeline::step_keyframe(bool forward) {
+    if (!m_video_track) {
+        return false;
+    }
+    const auto index = m_media_extractor->get_keyframe_index(
+        m_video_track->get_info()->track_id);
+    const auto position_ms = m_video_render->get_current_position_ms();
+
+    // Backwards skips the keyframe of the GOP being shown, otherwise a
+    // repeated step would keep landing on it
+    std::optional<keyframe_entry> target;
+    if (forward) {
+        target = index.after(position_ms);
+    } else if (const auto current = index.at_or_before(position_ms)) {
+        target = index.before(current->pts_ms);
+    }
+    if (!target) {
+        LOG_DEBUG("No keyframe {} {}ms ({} indexed)",
+                  forward ? "after" : "before", position_ms, index.size());
+        return false;
+    }
+    return seek(target->pts_ms, seek_mode::keyframe);
+}
+
+bool media_pipeline::accept_frame(const media_sample &frame,
+                                  bool drives_clock) {
+    if (frame.pts < m_discard_before_ms.load(std::memory_order_relaxed)) {
+        m_frames_dropped_early.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (drives_clock && m_rebase_on_first_frame.exchange(false)) {
+        m_media_clock.rebase(frame.pts);
+    }
+    return true;
+}
+
+bool media_pipeline::wait_while_paused(std::stop_token st) {
+    if (!m_paused) {
+        return !st.stop_requested();
+    }
+    std::unique_lock lock(m_pause_mutex);
+    m_pause_cv.wait(lock, st, [this] { return !m_paused; });
+    return !st.stop_requested();
+}
+
+std::chrono::milliseconds media_pipeline::next_render_wait() const {
+    if (m_paused) {
+        return kMaxRenderWait;
+    }
+    const auto next_due_ms = m_video_render->get_next_frame_due_ms();
+    if (!next_due_ms) {
+        return kMaxRenderWait;
+    }
+    const auto wait = std::chrono::milliseconds(
+        *next_due_ms - m_media_clock.get_video_time_ms());
+    return std::clamp(wait, 0ms, kMaxRenderWait);
+}
+
+bool media_pipeline::advance_clock() {
+    // Started by the renderers once the first frame arrives
+    if (!m_media_clock.is_started()) {
+        return false;
+    }
+    const auto video_due_ms = m_video_render->get_next_frame_due_ms();
+    const auto audio_due_ms = m_audio_render->get_next_frame_due_ms();
+
+    // A track still decoding with nothing queued holds the clock, or its
+    // frames arrive late. Not while the other renderer is full: its decoder
+    // then blocks the buffering thread that feeds the waiting track.
+    const auto is_full = [](const queue_stats &stats) {
+        return stats.capacity > 0 && stats.size >= stats.capacity;
+    };
+    if (m_video_track && !m_video_at_eos && !video_due_ms &&
+        !(audio_due_ms && is_full(m_audio_render->get_queue_stats()))) {
+        return false;
+    }
+    if (m_audio_track && !m_audio_at_eos && !audio_due_ms &&
+        !(video_due_ms && is_full(m_video_render->get_queue_stats()))) {
+        return false;
+    }
+
+    std::optional<int64_t> target_ms;
+    if (video_due_ms) {
+        target_ms = *video_due_ms + m_media_clock.get_audio_latency_ms();
+    }
+    if (audio_due_ms) {
+        target_ms = std::min(target_ms.value_or(*audio_due_ms), *audio_due_ms);
+    }
+    // Drained, or the next frame is already due and waits on its renderer
+    if (!target_ms || *target_ms <= m_media_clock.get_time_ms()) {
+        return false;
+    }
+    m_media_clock.advance_to(*target_ms);
+    return true;
 }
 
 void media_pipeline::pause() {
     LOG_DEBUG("Playback paused");
-    m_paused = true;
+    {
+        std::lock_guard lock(m_pause_mutex);
+        m_paused = true;
+    }
     if (m_video_render)
         m_video_render->pause();
     if (m_audio_render)
@@ -189,7 +483,11 @@ void media_pipeline::pause() {
 
 void media_pipeline::resume() {
     LOG_DEBUG("Playback resumed");
-    m_paused = false;
+    {
+        std::lock_guard lock(m_pause_mutex);
+        m_paused = false;
+    }
+    m_pause_cv.notify_all();
     if (m_video_render)
         m_video_render->resume();
     if (m_audio_render)
@@ -202,6 +500,10 @@ void media_pipeline::stop() {
     LOG_DEBUG("Playback stopping");
     m_running = false;
 
+    m_buffering_thread.request_stop();
+    m_video_decoder_thread.request_stop();
+    m_audio_decoder_thread.request_stop();
+
     for (auto &t : m_tracks) {
         t->shutdown();
     }
@@ -219,24 +521,33 @@ std::shared_ptr<media_info> media_pipeline::get_media_info() const {
 pipeline_stats media_pipeline::get_stats() const {
     pipeline_stats stats;
 
+    // Copies keep the tracks alive even if seek() replaces them meanwhile
+    std::shared_ptr<track> video_track;
+    std::shared_ptr<track> audio_track;
+    std::chrono::steady_clock::time_point load_started;
+    {
+        std::lock_guard lock{m_stats_mutex};
+        video_track = m_video_track;
+        audio_track = m_audio_track;
+        stats.startup = m_startup;
+        load_started = m_load_started;
+        stats.progress.duration_ms = m_duration_ms;
+    }
+
     if (m_video_render) {
         stats.progress.position_ms = m_video_render->get_current_position_ms();
     }
-    if (m_media_extractor) {
-        auto info = m_media_extractor->get_media_info();
-        if (info) {
-            stats.progress.duration_ms =
-                static_cast<int64_t>(info->duration / 1000);
-        }
-    }
+    stats.progress.end_of_stream = (video_track || audio_track) &&
+                                   (!video_track || m_video_at_eos) &&
+                                   (!audio_track || m_audio_at_eos);
 
     stats.media_source_buffered_bytes = m_media_source->available();
 
-    if (m_video_track) {
-        stats.video_track_queue = m_video_track->get_queue_stats();
+    if (video_track) {
+        stats.video_track_queue = video_track->get_queue_stats();
     }
-    if (m_audio_track) {
-        stats.audio_track_queue = m_audio_track->get_queue_stats();
+    if (audio_track) {
+        stats.audio_track_queue = audio_track->get_queue_stats();
     }
     if (m_video_render) {
         stats.video_renderer_queue = m_video_render->get_queue_stats();
@@ -245,6 +556,48 @@ pipeline_stats media_pipeline::get_stats() const {
         stats.audio_renderer_queue = m_audio_render->get_queue_stats();
     }
 
+    stats.video_decoder.threading = m_config.video_decoder_threading;
+    stats.video_decoder.frames_decoded =
+        m_video_frames_decoded.load(std::memory_order_relaxed);
+    const auto decode_ns = m_video_decode_ns.load(std::memory_order_relaxed);
+    if (decode_ns > 0) {
+        stats.video_decoder.decode_fps =
+            static_cast<double>(stats.video_decoder.frames_decoded) * 1e9 /
+            static_cast<double>(decode_ns);
+    }
+
+    if (m_video_render) {
+        stats.playback.video = m_video_render->get_render_counters();
+    }
+    if (m_audio_render) {
+        stats.playback.audio = m_audio_render->get_render_counters();
+    }
+    stats.playback.dropped_early =
+        m_frames_dropped_early.load(std::memory_order_relaxed);
+    stats.playback.clock_correction_ms =
+        m_media_clock.get_audio_correction_ms();
+
+    stats.latency.demux = m_demux_latency.snapshot();
+    stats.latency.decode = m_decode_latency.snapshot();
+    if (video_track) {
+        stats.latency.track_queue = video_track->get_wait_stats();
+    }
+    if (m_video_render) {
+        stats.latency.video_render = m_video_render->get_latency_stats();
+    }
+    if (m_audio_render) {
+        stats.latency.audio_queue = m_audio_render->get_queue_latency();
+    }
+
+    if (m_video_render) {
+        // A present left over from before this load() does not count
+        const auto first_frame = m_video_render->get_first_frame_time();
+        if (first_frame && *first_frame >= load_started) {
+            stats.startup.time_to_first_frame_us =
+                utilities::elapsed_us(load_started, *first_frame);
+        }
+    }
+
     return stats;
 }
 
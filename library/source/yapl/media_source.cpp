@@ -4,10 +4,11 @@
 
 namespace yapl {
 
-media_source::media_source() : m_data_source{std::unique_ptr<data_sources::file>{}} {}
+media_source::media_source(const source_config& config)
+    : m_config{config}, m_data_source{std::unique_ptr<data_sources::file>{}} {}
 
 void media_source::open(const std::string_view url) {
-    m_data_source = data_sources::create(url);
+    m_data_source = data_sources::create(url, m_config);
     data_sources::visit(m_data_source, [](auto& ds) { ds.open(); });
 }
 
@@ -37,4 +38,14 @@ void media_source::reset() {
     data_sources::visit(m_data_source, [](auto& ds) { ds.reset(); });
 }
 
+bool media_source::seek(size_t offset) {
+    return data_sources::visit(m_data_source, [offset](auto& ds) {
+        return ds.seek(offset);
+    });
+}
+
+std::optional<size_t> media_source::size() const {
+    return data_sources::visit(m_data_source, [](const auto& ds) { return ds.size(); });
+}
+
 } // namespace yapl
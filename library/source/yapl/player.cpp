@@ -48,6 +48,18 @@ pipeline_stats player::get_stats() const { return m_media_pipeline->get_stats();
 
 void player::stop() { m_media_pipeline->stop(); }
 
+bool player::seek(int64_t position_ms, seek_mode mode) {
+    return m_media_pipeline->seek(position_ms, mode);
+}
+
+bool player::step_keyframe(bool forward) {
+    return m_media_pipeline->step_keyframe(forward);
+}
+
+void player::set_keyframes_only(bool enabled) {
+    m_media_pipeline->set_keyframes_only(enabled);
+}
+
 void player::set_command_callback(input::command_callback callback) {
     m_media_pipeline->set_command_callback(std::move(callback));
 }
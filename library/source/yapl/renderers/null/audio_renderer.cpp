@@ -0,0 +1,125 @@
+#include "yapl/renderers/null/audio_renderer.hpp"
+
+#include "yapl/detail/debug.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/renderers/render_tolerances.hpp"
+
+#include <chrono>
+
+namespace yapl::renderers::null {
+
+audio_renderer::audio_renderer(media_clock &clock, size_t queue_size,
+                               queue_kind kind, render_pacing pacing)
+    : m_clock{clock}, m_pacing{pacing}, m_frames{queue_size, kind} {}
+
+audio_renderer::~audio_renderer() {
+    stop();
+    LOG_TRACE("Null audio renderer destroyed");
+}
+
+void audio_renderer::push_frame(std::shared_ptr<media_sample> frame) {
+    if (m_frames.is_shutdown()) {
+        LOG_ERROR("Audio renderer is shutdown");
+        return;
+    }
+    frame->queued_at = std::chrono::steady_clock::now();
+    m_frames.push(frame);
+}
+
+void audio_renderer::render() {
+    if (m_pacing == render_pacing::as_fast_as_possible) {
+        while (auto frame = m_frames.try_pop()) {
+            m_queue_latency.record(std::chrono::steady_clock::now() -
+                                   (*frame)->queued_at);
+            consume(**frame);
+        }
+        return;
+    }
+
+    if (m_clock.is_paused()) {
+        return;
+    }
+
+    if (!m_pending_frame) {
+        m_pending_frame = m_frames.try_pop();
+        if (!m_pending_frame) {
+            return;
+        }
+        m_queue_latency.record(std::chrono::steady_clock::now() -
+                               (*m_pending_frame)->queued_at);
+    }
+
+    // Audio-only streams have no video renderer to start the clock
+    if (!m_clock.is_started()) {
+        m_clock.start();
+    }
+
+    // Everything up to the clock is "played" in one go; the render loop
+    // wakes often enough that this stays within a few milliseconds
+    const int64_t playback_pos = m_clock.get_time_ms();
+    while (m_pending_frame) {
+        auto frame = *m_pending_frame;
+        if (frame->pts > playback_pos) {
+            return;
+        }
+        if (frame->pts < playback_pos - kLateAudioMs) {
+            m_frames_dropped_late.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            consume(*frame);
+        }
+        m_pending_frame = m_frames.try_pop();
+        if (m_pending_frame) {
+            m_queue_latency.record(std::chrono::steady_clock::now() -
+                                   (*m_pending_frame)->queued_at);
+        }
+    }
+}
+
+void audio_renderer::consume(const media_sample &frame) {
+    m_frames_rendered.fetch_add(1, std::memory_order_relaxed);
+    if (m_pacing == render_pacing::clock) {
+        m_clock.set_audio_position_ms(frame.pts);
+    }
+}
+
+void audio_renderer::pause() {}
+
+void audio_renderer::resume() {}
+
+void audio_renderer::stop() {
+    m_frames.shutdown();
+    m_pending_frame.reset();
+}
+
+void audio_renderer::flush() {
+    while (m_frames.try_pop()) {
+    }
+    m_pending_frame.reset();
+    m_clock.set_audio_position_ms(std::nullopt);
+}
+
+queue_stats audio_renderer::get_queue_stats() const { return m_frames.stats(); }
+
+std::optional<int64_t> audio_renderer::get_next_frame_due_ms() const {
+    if (m_pacing == render_pacing::clock && m_pending_frame) {
+        return (*m_pending_frame)->pts;
+    }
+    // Queued frames are taken on the next render()
+    if (m_frames.size() == 0) {
+        return std::nullopt;
+    }
+    return m_clock.get_time_ms();
+}
+
+latency_stats audio_renderer::get_queue_latency() const {
+    return m_queue_latency.snapshot();
+}
+
+audio_render_counters audio_renderer::get_render_counters() const {
+    return {.rendered = m_frames_rendered.load(std::memory_order_relaxed),
+            .dropped_late =
+                m_frames_dropped_late.load(std::memory_order_relaxed),
+            .underruns = 0};
+}
+
+} // namespace yapl::renderers::null
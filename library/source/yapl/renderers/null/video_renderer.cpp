@@ -0,0 +1,141 @@
+#include "yapl/renderers/null/video_renderer.hpp"
+
+#include "yapl/detail/debug.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/renderers/render_tolerances.hpp"
+
+namespace yapl::renderers::null {
+
+video_renderer::video_renderer(media_clock &clock, size_t queue_size,
+                               queue_kind kind, render_pacing pacing)
+    : m_clock{clock}, m_pacing{pacing}, m_frames{queue_size, kind} {}
+
+video_renderer::~video_renderer() {
+    stop();
+    LOG_TRACE("Null video renderer destroyed");
+}
+
+void video_renderer::resize(size_t /*width*/, size_t /*height*/) {}
+
+void video_renderer::push_frame(std::shared_ptr<media_sample> frame) {
+    if (m_frames.is_shutdown()) {
+        LOG_ERROR("Video renderer is shutdown");
+        return;
+    }
+    frame->queued_at = std::chrono::steady_clock::now();
+    m_frames.push(frame);
+}
+
+void video_renderer::pause() { m_clock.pause(); }
+
+void video_renderer::resume() { m_clock.resume(); }
+
+void video_renderer::stop() {
+    m_frames.shutdown();
+    m_pending_frame.reset();
+    m_clock.reset();
+    m_first_frame_time = std::chrono::steady_clock::time_point{};
+}
+
+void video_renderer::flush() {
+    while (m_frames.try_pop()) {
+    }
+    m_pending_frame.reset();
+}
+
+void video_renderer::render() {
+    if ((!m_pending_frame && m_frames.is_empty()) || m_clock.is_paused()) {
+        return;
+    }
+
+    if (!m_clock.is_started()) {
+        m_clock.start();
+    }
+
+    // Drain everything queued: the render loop only limits throughput
+    if (m_pacing == render_pacing::as_fast_as_possible) {
+        while (auto frame = m_frames.try_pop()) {
+            m_queue_latency.record(std::chrono::steady_clock::now() -
+                                   (*frame)->queued_at);
+            consume(**frame);
+        }
+        return;
+    }
+
+    if (!m_pending_frame) {
+        m_pending_frame = m_frames.try_pop();
+        if (!m_pending_frame) {
+            return;
+        }
+        m_queue_latency.record(std::chrono::steady_clock::now() -
+                               (*m_pending_frame)->queued_at);
+    }
+
+    auto frame = *m_pending_frame;
+    const auto video_time_ms = m_clock.get_video_time_ms();
+
+    if (frame->pts > video_time_ms + kFrameToleranceMs) {
+        return;
+    }
+
+    m_pending_frame.reset();
+
+    if (frame->pts < video_time_ms - kFrameToleranceMs) {
+        m_frames_dropped_late.fetch_add(1, std::memory_order_relaxed);
+        m_current_position_ms = frame->pts;
+        return;
+    }
+
+    consume(*frame);
+}
+
+void video_renderer::consume(const media_sample &frame) {
+    m_current_position_ms = frame.pts;
+    m_frames_rendered.fetch_add(1, std::memory_order_relaxed);
+    if (m_first_frame_time.load() == std::chrono::steady_clock::time_point{}) {
+        m_first_frame_time = std::chrono::steady_clock::now();
+    }
+}
+
+queue_stats video_renderer::get_queue_stats() const { return m_frames.stats(); }
+
+int64_t video_renderer::get_current_position_ms() const {
+    return m_current_position_ms.load();
+}
+
+std::optional<int64_t> video_renderer::get_next_frame_due_ms() const {
+    // Due right away while frames wait, so the render loop does not sleep
+    if (m_pacing == render_pacing::as_fast_as_possible) {
+        if (m_frames.size() == 0) {
+            return std::nullopt;
+        }
+        return m_clock.get_video_time_ms();
+    }
+    if (!m_pending_frame) {
+        return std::nullopt;
+    }
+    return (*m_pending_frame)->pts - kFrameToleranceMs;
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+video_renderer::get_first_frame_time() const {
+    const auto time = m_first_frame_time.load();
+    if (time == std::chrono::steady_clock::time_point{}) {
+        return std::nullopt;
+    }
+    return time;
+}
+
+video_render_latency video_renderer::get_latency_stats() const {
+    return {.queue_wait = m_queue_latency.snapshot(), .upload = {}, .present = {}};
+}
+
+video_render_counters video_renderer::get_render_counters() const {
+    video_render_counters counters;
+    counters.rendered = m_frames_rendered.load(std::memory_order_relaxed);
+    counters.dropped_late =
+        m_frames_dropped_late.load(std::memory_order_relaxed);
+    return counters;
+}
+
+} // namespace yapl::renderers::null
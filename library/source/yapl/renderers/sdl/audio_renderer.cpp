@@ -1,9 +1,14 @@
 #include "yapl/renderers/sdl/audio_renderer.hpp"
 #include "yapl/detail/debug.hpp"
 #include "yapl/renderers/media_clock.hpp"
+#include "yapl/renderers/render_tolerances.hpp"
 
 #include <SDL.h>
 #include <SDL_audio.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
 #include <fmt/format.h>
 
 namespace yapl::renderers::sdl {
@@ -16,20 +21,39 @@ constexpr int kBytesPerSample = sizeof(float);
 constexpr int kBytesPerSecond = kSampleRate * kChannels * kBytesPerSample;
 
 // Convert bytes to milliseconds of audio
-constexpr int64_t bytes_to_ms(uint32_t bytes) {
+constexpr int64_t bytes_to_ms(uint64_t bytes) {
     return static_cast<int64_t>(bytes) * 1000 / kBytesPerSecond;
 }
 
+constexpr size_t ms_to_bytes(size_t ms) {
+    // Whole sample frames only
+    constexpr size_t kFrameBytes = kChannels * kBytesPerSample;
+    return ms * kBytesPerSecond / 1000 / kFrameBytes * kFrameBytes;
+}
+
 // Target SDL buffer size in bytes (~100ms of audio)
 // This is how far ahead we queue audio
 constexpr uint32_t kTargetQueueBytes = kBytesPerSecond / 10;
 
 // Maximum SDL buffer before we stop queuing (~200ms)
 constexpr uint32_t kMaxQueueBytes = kBytesPerSecond / 5;
+
+// A frame is handed to SDL this long before it is due after what is
+// already queued
+constexpr int64_t kQueueAheadMs = 50;
+
+// Callback mode: device buffer bounds (sample frames, powers of two)
+constexpr uint16_t kMinDeviceSamples = 256;
+constexpr uint16_t kMaxDeviceSamples = 4096;
+
+// Frame start positions kept for the callback-mode ring; more than it can
+// hold at any sensible latency
+constexpr size_t kMaxMarkers = 256;
 } // namespace
 
-audio_renderer::audio_renderer(media_clock &clock, size_t queue_size)
-    : m_clock{clock}, m_frames{queue_size} {
+audio_renderer::audio_renderer(media_clock &clock, size_t queue_size,
+                               queue_kind kind, audio_output_config output)
+    : m_clock{clock}, m_output{output}, m_frames{queue_size, kind} {
     if (SDL_Init(SDL_INIT_AUDIO) != 0) {
         throw std::runtime_error("Failed to Initialize SDL audio!");
     }
@@ -43,7 +67,23 @@ audio_renderer::audio_renderer(media_clock &clock, size_t queue_size)
     want.samples = 1024;
     want.callback = NULL;
 
+    if (m_output.mode == audio_output_mode::callback) {
+        const auto device_samples = std::bit_floor(static_cast<size_t>(
+            kSampleRate * m_output.target_latency_ms / 1000 / 2));
+        want.samples = static_cast<uint16_t>(
+            std::clamp<size_t>(device_samples, kMinDeviceSamples,
+                               kMaxDeviceSamples));
+        want.callback = &audio_renderer::fill_device_callback;
+        want.userdata = this;
+        m_pcm_ring.emplace(std::max<size_t>(
+            ms_to_bytes(m_output.target_latency_ms),
+            static_cast<size_t>(kChannels * kBytesPerSample)));
+        m_markers.emplace(kMaxMarkers);
+    }
+
     m_audio_device.emplace(nullptr, 0, &want, &have, 0);
+    m_device_buffer_ms = bytes_to_ms(
+        static_cast<uint64_t>(have.samples) * kChannels * kBytesPerSample);
 
     SDL_PauseAudioDevice(m_audio_device->get(), 0);
 }
@@ -54,14 +94,120 @@ audio_renderer::~audio_renderer() {
 }
 
 void audio_renderer::push_frame(std::shared_ptr<media_sample> frame) {
+    if (m_pcm_ring) {
+        push_to_ring(std::move(frame));
+        return;
+    }
     if (m_frames.is_shutdown()) {
         LOG_ERROR("Audio renderer is shutdown");
         return;
     }
+    frame->queued_at = std::chrono::steady_clock::now();
     m_frames.push(frame);
 }
 
+void audio_renderer::push_to_ring(std::shared_ptr<media_sample> frame) {
+    if (m_pcm_ring->is_shutdown()) {
+        LOG_ERROR("Audio renderer is shutdown");
+        return;
+    }
+    if (m_clock.is_started() &&
+        frame->pts < m_clock.get_time_ms() - kLateAudioMs) {
+        m_frames_dropped_late.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // A full marker queue only costs position accuracy until the next frame
+    m_markers->try_push({.offset = m_pcm_ring->bytes_written(),
+                         .pts = frame->pts,
+                         .pushed_at = std::chrono::steady_clock::now()});
+    m_ring_fed = true;
+    // Blocks while the ring is full: the device paces the decoder
+    if (m_pcm_ring->write(frame->data) == frame->data.size()) {
+        m_frames_rendered.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void audio_renderer::fill_device_callback(void *userdata, Uint8 *stream,
+                                          int len) {
+    static_cast<audio_renderer *>(userdata)->fill_device(
+        {stream, static_cast<size_t>(len)});
+}
+
+void audio_renderer::fill_device(std::span<uint8_t> out) {
+    const bool playing = m_clock.is_started() && !m_clock.is_paused();
+    const size_t copied = playing ? m_pcm_ring->read(out) : 0;
+    std::memset(out.data() + copied, 0, out.size() - copied);
+    if (!playing) {
+        return;
+    }
+
+    // Only counted once audio flows again, so the end of the stream is not an
+    // underrun
+    if (copied > 0 && m_device_starved.exchange(false)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (copied < out.size() && m_ring_fed) {
+        m_device_starved = true;
+    }
+}
+
 void audio_renderer::render() {
+    if (m_pcm_ring) {
+        render_callback();
+    } else {
+        render_queued();
+    }
+}
+
+void audio_renderer::render_callback() {
+    auto &clock = m_clock;
+
+    if (clock.is_paused() || !clock.is_started()) {
+        return;
+    }
+
+    const int64_t buffered_ms =
+        bytes_to_ms(m_pcm_ring->size()) + m_device_buffer_ms;
+    clock.set_audio_latency_ms(buffered_ms);
+
+    // Find the frame the device is reading from
+    const auto read = m_pcm_ring->bytes_read();
+    while (true) {
+        if (!m_next_marker) {
+            m_next_marker = m_markers->try_pop();
+        }
+        if (!m_next_marker || m_next_marker->offset > read) {
+            break;
+        }
+        m_queue_latency.record(std::chrono::steady_clock::now() -
+                               m_next_marker->pushed_at);
+        m_current_marker = m_next_marker;
+        m_next_marker.reset();
+    }
+    if (!m_current_marker) {
+        return;
+    }
+
+    // The device plays what it pulled one buffer later
+    const int64_t played_until_ms = m_current_marker->pts +
+                                    bytes_to_ms(read - m_current_marker->offset) -
+                                    m_device_buffer_ms;
+    clock.set_audio_position_ms(played_until_ms);
+    if (!m_device_starved) {
+        clock.follow_audio(played_until_ms);
+    }
+
+    const int64_t clock_ms = clock.get_time_ms();
+    if (clock_ms - m_last_log_time_ms > 1000) {
+        LOG_INFO("[AUDIO] clock: {}ms, ring: {}ms, device: {}ms, playing: {}ms",
+                 clock_ms, bytes_to_ms(m_pcm_ring->size()), m_device_buffer_ms,
+                 played_until_ms);
+        m_last_log_time_ms = clock_ms;
+    }
+}
+
+void audio_renderer::render_queued() {
     auto &clock = m_clock;
 
     if (clock.is_paused() || !clock.is_started()) {
@@ -72,6 +218,21 @@ void audio_renderer::render() {
     int64_t sdl_buffer_ms = bytes_to_ms(queued_bytes);
 
     clock.set_audio_latency_ms(sdl_buffer_ms);
+    if (m_queued_until_ms) {
+        // What the device has consumed: everything handed to it minus what
+        // is still queued
+        const int64_t played_until_ms = *m_queued_until_ms - sdl_buffer_ms;
+        clock.set_audio_position_ms(played_until_ms);
+        // Only counted as an underrun once more audio arrives, so the end
+        // of the stream is not one
+        if (queued_bytes == 0) {
+            m_starved = true;
+        } else {
+            // A drained device is not playing; the clock runs on its own
+            // until audio resumes (or for video past the end of the audio)
+            clock.follow_audio(played_until_ms);
+        }
+    }
 
     if (queued_bytes > kMaxQueueBytes) {
         return;
@@ -82,38 +243,49 @@ void audio_renderer::render() {
         if (!m_pending_frame) {
             return;
         }
+        m_queue_latency.record(std::chrono::steady_clock::now() -
+                               (*m_pending_frame)->queued_at);
     }
 
     auto frame = *m_pending_frame;
     int64_t audio_playback_pos = clock.get_time_ms();
 
-    if (frame->pts > audio_playback_pos + sdl_buffer_ms + 50) {
+    if (frame->pts > audio_playback_pos + sdl_buffer_ms + kQueueAheadMs) {
         return;
     }
 
-    if (frame->pts < audio_playback_pos - 100) {
+    if (frame->pts < audio_playback_pos - kLateAudioMs) {
         LOG_DEBUG("Dropping late audio. PTS: {}ms, playback: {}ms", frame->pts,
                   audio_playback_pos);
+        m_frames_dropped_late.fetch_add(1, std::memory_order_relaxed);
         m_pending_frame.reset();
         return;
     }
 
     m_pending_frame.reset();
 
-    static int64_t last_log_time = 0;
-    if (audio_playback_pos - last_log_time > 1000) {
+    if (audio_playback_pos - m_last_log_time_ms > 1000) {
         int64_t audio_heard_now = audio_playback_pos - sdl_buffer_ms;
         LOG_INFO("[AUDIO] clock: {}ms, PTS: {}ms, SDL buf: {}ms, playing: {}ms",
                  audio_playback_pos, frame->pts, sdl_buffer_ms,
                  audio_heard_now);
-        last_log_time = audio_playback_pos;
+        m_last_log_time_ms = audio_playback_pos;
     }
 
     auto result = SDL_QueueAudio(m_audio_device->get(), frame->data.data(),
                                  static_cast<uint32_t>(frame->data.size()));
     if (result < 0) {
         LOG_ERROR("SDL_QueueAudio failed: {}", SDL_GetError());
+        return;
+    }
+
+    m_frames_rendered.fetch_add(1, std::memory_order_relaxed);
+    if (m_starved) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        m_starved = false;
     }
+    m_queued_until_ms = frame->pts + bytes_to_ms(static_cast<uint32_t>(
+                                         frame->data.size()));
 }
 
 void audio_renderer::pause() {
@@ -132,7 +304,15 @@ void audio_renderer::resume() {
 
 void audio_renderer::stop() {
     m_frames.shutdown();
+    if (m_pcm_ring) {
+        // Wakes a decoder blocked on a full ring
+        m_pcm_ring->shutdown();
+        m_markers->shutdown();
+    }
     m_pending_frame.reset();
+    m_queued_until_ms.reset();
+    m_starved = false;
+    m_queue_latency.reset();
     if (m_audio_device) {
         SDL_PauseAudioDevice(m_audio_device->get(), 1);
         SDL_ClearQueuedAudio(m_audio_device->get());
@@ -140,6 +320,65 @@ void audio_renderer::stop() {
     LOG_TRACE("Audio renderer stopped");
 }
 
-queue_stats audio_renderer::get_queue_stats() const { return m_frames.stats(); }
+void audio_renderer::flush() {
+    while (m_frames.try_pop()) {
+    }
+    m_pending_frame.reset();
+    // Emptying the device on purpose is not an underrun
+    m_queued_until_ms.reset();
+    m_starved = false;
+    m_clock.set_audio_position_ms(std::nullopt);
+    if (m_pcm_ring) {
+        while (m_markers->try_pop()) {
+        }
+        m_current_marker.reset();
+        m_next_marker.reset();
+        m_ring_fed = false;
+        // Keeps the callback out while the ring is emptied
+        SDL_LockAudioDevice(m_audio_device->get());
+        m_pcm_ring->clear();
+        m_device_starved = false;
+        SDL_UnlockAudioDevice(m_audio_device->get());
+    }
+    if (m_audio_device) {
+        SDL_ClearQueuedAudio(m_audio_device->get());
+    }
+    LOG_TRACE("Audio renderer flushed");
+}
+
+queue_stats audio_renderer::get_queue_stats() const {
+    if (m_pcm_ring) {
+        return {.size = m_pcm_ring->size(), .capacity = m_pcm_ring->capacity()};
+    }
+    return m_frames.stats();
+}
+
+std::optional<int64_t> audio_renderer::get_next_frame_due_ms() const {
+    if (m_pcm_ring) {
+        // The device plays the ring out on its own; what it reached is due
+        if (m_pcm_ring->size() == 0) {
+            return std::nullopt;
+        }
+        return m_clock.get_audio_position_ms().value_or(m_clock.get_time_ms());
+    }
+    if (m_pending_frame) {
+        return (*m_pending_frame)->pts - kQueueAheadMs;
+    }
+    if (m_frames.size() == 0) {
+        return std::nullopt;
+    }
+    return m_clock.get_time_ms();
+}
+
+audio_render_counters audio_renderer::get_render_counters() const {
+    return {.rendered = m_frames_rendered.load(std::memory_order_relaxed),
+            .dropped_late =
+                m_frames_dropped_late.load(std::memory_order_relaxed),
+            .underruns = m_underruns.load(std::memory_order_relaxed)};
+}
+
+latency_stats audio_renderer::get_queue_latency() const {
+    return m_queue_latency.snapshot();
+}
 
 } // namespace yapl::renderers::sdl
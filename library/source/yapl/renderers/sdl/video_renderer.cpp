@@ -4,18 +4,21 @@
 #include "yapl/detail/debug.hpp"
 #include "yapl/media_sample.hpp"
 #include "yapl/renderers/media_clock.hpp"
+#include "yapl/renderers/render_tolerances.hpp"
+
+#include <cstdlib>
 
 namespace yapl::renderers::sdl {
 
 namespace {
 constexpr size_t kDefaultWidth = 640;
 constexpr size_t kDefaultHeight = 480;
-constexpr int64_t kFrameToleranceMs = 15;
 } // namespace
 
-video_renderer::video_renderer(media_clock &clock, size_t queue_size)
+video_renderer::video_renderer(media_clock &clock, size_t queue_size,
+                               queue_kind kind)
     : m_clock{clock}, m_width{kDefaultWidth}, m_height{kDefaultHeight},
-      m_frames{queue_size} {
+      m_frames{queue_size, kind} {
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         throw std::runtime_error("Failed to Initialize SDL video!");
     }
@@ -62,6 +65,7 @@ void video_renderer::push_frame(std::shared_ptr<media_sample> frame) {
         LOG_ERROR("Video renderer is shutdown");
         return;
     }
+    frame->queued_at = std::chrono::steady_clock::now();
     m_frames.push(frame);
 }
 
@@ -79,13 +83,24 @@ void video_renderer::stop() {
     m_frames.shutdown();
     m_pending_frame.reset();
     m_clock.reset();
+    m_first_frame_time = std::chrono::steady_clock::time_point{};
+    m_queue_latency.reset();
+    m_upload_latency.reset();
+    m_present_latency.reset();
     LOG_TRACE("Video renderer stopped");
 }
 
+void video_renderer::flush() {
+    while (m_frames.try_pop()) {
+    }
+    m_pending_frame.reset();
+    LOG_TRACE("Video renderer flushed");
+}
+
 void video_renderer::render() {
     auto &clock = m_clock;
 
-    if (m_frames.is_empty() || clock.is_paused()) {
+    if ((!m_pending_frame && m_frames.is_empty()) || clock.is_paused()) {
         return;
     }
 
@@ -98,6 +113,8 @@ void video_renderer::render() {
         if (!m_pending_frame) {
             return;
         }
+        m_queue_latency.record(std::chrono::steady_clock::now() -
+                               (*m_pending_frame)->queued_at);
     }
 
     auto frame = *m_pending_frame;
@@ -112,35 +129,75 @@ void video_renderer::render() {
     if (frame->pts < video_time_ms - kFrameToleranceMs) {
         LOG_DEBUG("Dropping late frame. PTS: {}ms, video_time: {}ms",
                   frame->pts, video_time_ms);
+        m_frames_dropped_late.fetch_add(1, std::memory_order_relaxed);
         m_current_position_ms = frame->pts;
         return;
     }
 
     m_current_position_ms = frame->pts;
 
-    static int64_t last_log_time = 0;
-    if (video_time_ms - last_log_time > 1000) {
+    if (video_time_ms - m_last_log_time_ms > 1000) {
         LOG_INFO(
             "[VIDEO] video_time: {}ms, PTS: {}ms, diff: {}ms, audio_lat: {}ms",
             video_time_ms, frame->pts, video_time_ms - frame->pts,
             clock.get_audio_latency_ms());
-        last_log_time = video_time_ms;
+        m_last_log_time_ms = video_time_ms;
+    }
+
+    const auto upload_start = std::chrono::steady_clock::now();
+    upload_frame(*frame);
+    const auto present_start = std::chrono::steady_clock::now();
+    m_upload_latency.record(present_start - upload_start);
+
+    SDL_RenderClear(m_renderer->get());
+    SDL_RenderCopy(m_renderer->get(), m_texture->get(), nullptr, nullptr);
+    SDL_RenderPresent(m_renderer->get());
+    m_present_latency.record(std::chrono::steady_clock::now() -
+                             present_start);
+    m_frames_rendered.fetch_add(1, std::memory_order_relaxed);
+    record_drift(frame->pts);
+
+    if (m_first_frame_time.load() == std::chrono::steady_clock::time_point{}) {
+        m_first_frame_time = std::chrono::steady_clock::now();
+    }
+}
+
+void video_renderer::record_drift(int64_t video_pts_ms) {
+    const auto audio_position_ms = m_clock.get_audio_position_ms();
+    if (!audio_position_ms || m_clock.is_paused()) {
+        return;
+    }
+    const int64_t drift_ms = video_pts_ms - *audio_position_ms;
+    m_drift_last_ms.store(drift_ms, std::memory_order_relaxed);
+    m_drift_sum_ms.fetch_add(drift_ms, std::memory_order_relaxed);
+    const int64_t magnitude_ms = std::abs(drift_ms);
+    if (magnitude_ms > m_drift_max_abs_ms.load(std::memory_order_relaxed)) {
+        m_drift_max_abs_ms.store(magnitude_ms, std::memory_order_relaxed);
+    }
+    m_drift_samples.fetch_add(1, std::memory_order_release);
+}
+
+void video_renderer::upload_frame(const media_sample &frame) {
+    // Decoder-owned planes go up with their native strides; no repacking
+    if (!frame.planes.empty()) {
+        const auto &planes = frame.planes;
+        SDL_UpdateYUVTexture(m_texture->get(), nullptr, planes.data[0],
+                             planes.linesize[0], planes.data[1],
+                             planes.linesize[1], planes.data[2],
+                             planes.linesize[2]);
+        return;
     }
 
     const int y_pitch = static_cast<int>(m_width);
     const int u_pitch = static_cast<int>(m_width / 2);
     const int v_pitch = static_cast<int>(m_width / 2);
 
-    uint8_t *const y_plane = frame->data.data();
-    uint8_t *const u_plane = y_plane + m_width * m_height;
-    uint8_t *const v_plane = u_plane + (m_width * m_height) / 4;
+    const uint8_t *const y_plane = frame.data.data();
+    const uint8_t *const u_plane = y_plane + m_width * m_height;
+    const uint8_t *const v_plane = u_plane + (m_width * m_height) / 4;
 
     SDL_UpdateYUVTexture(m_texture->get(), nullptr, y_plane, y_pitch, u_plane,
                          u_pitch, v_plane, v_pitch);
-
-    SDL_RenderClear(m_renderer->get());
-    SDL_RenderCopy(m_renderer->get(), m_texture->get(), nullptr, nullptr);
-    SDL_RenderPresent(m_renderer->get());
 }
 
 queue_stats video_renderer::get_queue_stats() const { return m_frames.stats(); }
@@ -149,4 +206,44 @@ int64_t video_renderer::get_current_position_ms() const {
     return m_current_position_ms.load();
 }
 
+std::optional<int64_t> video_renderer::get_next_frame_due_ms() const {
+    if (!m_pending_frame) {
+        return std::nullopt;
+    }
+    return (*m_pending_frame)->pts - kFrameToleranceMs;
+}
+
+video_render_latency video_renderer::get_latency_stats() const {
+    return {.queue_wait = m_queue_latency.snapshot(),
+            .upload = m_upload_latency.snapshot(),
+            .present = m_present_latency.snapshot()};
+}
+
+video_render_counters video_renderer::get_render_counters() const {
+    video_render_counters counters;
+    counters.rendered = m_frames_rendered.load(std::memory_order_relaxed);
+    counters.dropped_late =
+        m_frames_dropped_late.load(std::memory_order_relaxed);
+
+    auto &drift = counters.av_drift;
+    drift.samples = m_drift_samples.load(std::memory_order_acquire);
+    if (drift.samples > 0) {
+        drift.last_ms = m_drift_last_ms.load(std::memory_order_relaxed);
+        const auto sum_ms = m_drift_sum_ms.load(std::memory_order_relaxed);
+        drift.mean_ms = static_cast<double>(sum_ms) /
+                        static_cast<double>(drift.samples);
+        drift.max_abs_ms = m_drift_max_abs_ms.load(std::memory_order_relaxed);
+    }
+    return counters;
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+video_renderer::get_first_frame_time() const {
+    const auto time = m_first_frame_time.load();
+    if (time == std::chrono::steady_clock::time_point{}) {
+        return std::nullopt;
+    }
+    return time;
+}
+
 } // namespace yapl::renderers::sdl
@@ -1,21 +1,29 @@
 #include "yapl/track.hpp"
-#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/pipeline_queue.hpp"
 #include "yapl/media_sample.hpp"
 #include "yapl/track_info.hpp"
 
+#include <chrono>
+
 namespace yapl {
 
-track::track(std::shared_ptr<track_info> info)
+track::track(std::shared_ptr<track_info> info, size_t queue_size,
+             queue_kind kind)
     : m_track_info{info}, m_data_source_eos_reached{false},
-      m_buffered_duration{0},
-      m_sample_queue{blocking_queue<std::shared_ptr<media_sample>>(1024)} {}
+      m_buffered_duration{0}, m_sample_queue{queue_size, kind} {}
 
 void track::push_sample(const std::shared_ptr<media_sample> sample) {
     m_buffered_duration += sample->duration;
+    sample->queued_at = std::chrono::steady_clock::now();
     m_sample_queue.push(sample);
 }
 
-void track::set_data_source_reached_eos() { m_data_source_eos_reached = true; }
+void track::set_data_source_reached_eos() {
+    m_data_source_eos_reached = true;
+    // No more pushes will come: let pop() drain what is left, then report EOS
+    // instead of blocking the decoder thread forever
+    m_sample_queue.shutdown();
+}
 
 void track::shutdown() { m_sample_queue.shutdown(); }
 
@@ -23,6 +31,10 @@ std::shared_ptr<track_info> track::get_info() const { return m_track_info; }
 
 queue_stats track::get_queue_stats() const { return m_sample_queue.stats(); }
 
+latency_stats track::get_wait_stats() const {
+    return m_wait_latency.snapshot();
+}
+
 read_sample_result track::pop_sample() {
     if (m_sample_queue.is_empty() && m_data_source_eos_reached) {
         return {.stream_id = m_track_info->track_id,
@@ -38,6 +50,8 @@ read_sample_result track::pop_sample() {
                 .sample{}};
     }
 
+    m_wait_latency.record(std::chrono::steady_clock::now() -
+                          (*data)->queued_at);
     return {.stream_id = m_track_info->track_id,
             .error = read_sample_error_t::no_errror,
             .sample = *data};
@@ -0,0 +1,231 @@
+#include "yapl/track_info.hpp"
+#include "yapl/detail/debug.hpp"
+
+namespace yapl {
+
+namespace {
+// HEVC NAL unit types carried in hvcC arrays
+constexpr uint8_t kHevcSps = 33;
+constexpr uint8_t kHevcPps = 34;
+
+// H.264 profile_idc values whose avcC may carry chroma and bit depth
+constexpr bool is_avc_high_profile(uint8_t profile) noexcept {
+    return profile == 100 || profile == 110 || profile == 122 ||
+           profile == 144;
+}
+
+constexpr size_t kHvccHeaderSize = 23;
+constexpr uint8_t kAv1cMarkerVersion = 0x81;
+constexpr size_t kAv1cHeaderSize = 4;
+
+// Big-endian reader over a configuration record; reads past the end yield
+// zeroes and clear ok instead of touching memory
+struct record_reader {
+    std::span<const uint8_t> data;
+    size_t position{0};
+    bool ok{true};
+
+    uint8_t u8() {
+        if (position >= data.size()) {
+            ok = false;
+            return 0;
+        }
+        return data[position++];
+    }
+
+    uint16_t u16() {
+        const uint16_t high = u8();
+        return static_cast<uint16_t>(high << 8 | u8());
+    }
+
+    std::span<const uint8_t> bytes(size_t count) {
+        if (count > data.size() - position) {
+            ok = false;
+            position = data.size();
+            return {};
+        }
+        const auto result = data.subspan(position, count);
+        position += count;
+        return result;
+    }
+
+    void skip(size_t count) { bytes(count); }
+
+    [[nodiscard]] size_t remaining() const { return data.size() - position; }
+};
+
+enum class parameter_set_kind { sps, pps, other };
+
+void add_parameter_set(video_extra_data &extra, parameter_set_kind kind,
+                       std::span<const uint8_t> nal) {
+    extra.parameter_sets.emplace_back(nal.begin(), nal.end());
+    if (kind == parameter_set_kind::sps && extra.sps_count++ == 0) {
+        extra.sps_length = static_cast<uint16_t>(nal.size());
+        extra.sps_data.assign(nal.begin(), nal.end());
+    } else if (kind == parameter_set_kind::pps && extra.pps_count++ == 0) {
+        extra.pps_length = static_cast<uint16_t>(nal.size());
+        extra.pps_data.assign(nal.begin(), nal.end());
+    }
+}
+
+// Reads count length-prefixed NAL units of one kind
+void read_nal_array(record_reader &reader, video_extra_data &extra,
+                    parameter_set_kind kind, size_t count) {
+    for (size_t i = 0; i < count && reader.ok; ++i) {
+        const auto nal = reader.bytes(reader.u16());
+        if (reader.ok) {
+            add_parameter_set(extra, kind, nal);
+        }
+    }
+}
+
+bool parse_avcc(std::span<const uint8_t> data, video_extra_data &extra) {
+    record_reader reader{data};
+    extra.configuration_version = reader.u8();
+    if (extra.configuration_version != 1) {
+        return false;
+    }
+    extra.profile = reader.u8();
+    reader.skip(1); // profile_compatibility
+    extra.level = reader.u8();
+    const auto nal_size_length = extract_nal_size_length(reader.u8());
+
+    read_nal_array(reader, extra, parameter_set_kind::sps,
+                   extract_sps_count(reader.u8()));
+    read_nal_array(reader, extra, parameter_set_kind::pps, reader.u8());
+    // High profiles may append chroma and bit depth fields; the rest are
+    // always 8-bit
+    if (is_avc_high_profile(extra.profile) && reader.remaining() >= 4) {
+        reader.skip(1); // chroma_format
+        extra.bit_depth = (reader.u8() & 0b00000111) + 8;
+    } else {
+        extra.bit_depth = 8;
+    }
+
+    if (!reader.ok) {
+        return false;
+    }
+    extra.nal_size_length = nal_size_length;
+    return true;
+}
+
+bool parse_hvcc(std::span<const uint8_t> data, video_extra_data &extra) {
+    // Same test as libavcodec: Annex-B extradata starts with a start code
+    if (data.size() < kHvccHeaderSize ||
+        !(data[0] != 0 || data[1] != 0 || data[2] > 1)) {
+        return false;
+    }
+    record_reader reader{data};
+    extra.configuration_version = reader.u8();
+    extra.profile = reader.u8() & 0b00011111;
+    reader.skip(10); // compatibility and constraint flags
+    extra.level = reader.u8();
+    reader.skip(4); // segmentation, parallelism, chroma
+    extra.bit_depth = (reader.u8() & 0b00000111) + 8;
+    reader.skip(3); // chroma bit depth, frame rate
+    const auto nal_size_length = extract_nal_size_length(reader.u8());
+
+    const auto arrays = reader.u8();
+    for (size_t i = 0; i < arrays && reader.ok; ++i) {
+        const auto nal_type = reader.u8() & 0b00111111;
+        const auto kind = nal_type == kHevcSps   ? parameter_set_kind::sps
+                          : nal_type == kHevcPps ? parameter_set_kind::pps
+                                                 : parameter_set_kind::other;
+        read_nal_array(reader, extra, kind, reader.u16());
+    }
+
+    if (!reader.ok) {
+        return false;
+    }
+    extra.nal_size_length = nal_size_length;
+    return true;
+}
+
+// AV1 sizes are unsigned LEB128, at most 8 bytes
+uint64_t read_leb128(record_reader &reader) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        const auto byte = reader.u8();
+        value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+bool parse_av1c(std::span<const uint8_t> data, video_extra_data &extra) {
+    if (data.size() < kAv1cHeaderSize || data[0] != kAv1cMarkerVersion) {
+        return false;
+    }
+    extra.configuration_version = data[0] & 0x7f;
+    extra.profile = data[1] >> 5;
+    extra.level = data[1] & 0b00011111;
+    // high_bitdepth, then twelve_bit
+    const bool high_bitdepth = data[2] & 0b01000000;
+    const bool twelve_bit = data[2] & 0b00100000;
+    extra.bit_depth = !high_bitdepth ? 8 : twelve_bit ? 12 : 10;
+
+    // configOBUs: each OBU header is followed by its size unless it is the
+    // last OBU and has_size_field is clear
+    record_reader reader{data, kAv1cHeaderSize};
+    while (reader.remaining() > 0 && reader.ok) {
+        const auto start = reader.position;
+        const auto header = reader.u8();
+        if (header & 0b00000100) {
+            reader.skip(1); // extension header
+        }
+        const auto size = (header & 0b00000010)
+                              ? read_leb128(reader)
+                              : static_cast<uint64_t>(reader.remaining());
+        if (size > reader.remaining()) {
+            return false;
+        }
+        reader.skip(static_cast<size_t>(size));
+        if (reader.ok) {
+            add_parameter_set(extra, parameter_set_kind::other,
+                              data.subspan(start, reader.position - start));
+        }
+    }
+    return reader.ok;
+}
+} // namespace
+
+video_extra_data::video_extra_data(video_codec _codec,
+                                   std::span<const uint8_t> data)
+    : codec{_codec} {
+    raw_data.assign(data.begin(), data.end());
+
+    bool parsed = false;
+    switch (codec) {
+    case video_codec::h264:
+        parsed = parse_avcc(data, *this);
+        break;
+    case video_codec::hevc:
+        parsed = parse_hvcc(data, *this);
+        break;
+    case video_codec::av1:
+        parsed = parse_av1c(data, *this);
+        break;
+    case video_codec::vp9:
+    default:
+        return;
+    }
+    if (parsed) {
+        return;
+    }
+
+    // Keep nothing from a partial parse; the samples are passed through
+    configuration_version = profile = level = bit_depth = nal_size_length = 0;
+    sps_count = pps_count = 0;
+    sps_length = pps_length = 0;
+    sps_data.clear();
+    pps_data.clear();
+    parameter_sets.clear();
+    if (!data.empty() && data[0] != 0) {
+        LOG_WARN("Malformed {} configuration record ({} bytes)",
+                 video_codec_to_string(codec), data.size());
+    }
+}
+
+} // namespace yapl
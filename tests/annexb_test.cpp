@@ -0,0 +1,79 @@
+#include "yapl/detail/annexb.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+// Two NAL units: a 3-byte SPS-like unit and a 2-byte slice
+std::vector<uint8_t> make_avcc(size_t nal_length_size) {
+    const std::vector<std::vector<uint8_t>> nals = {{0x67, 0x42, 0x00},
+                                                    {0x65, 0x88}};
+    std::vector<uint8_t> packet;
+    for (const auto &nal : nals) {
+        for (size_t i = nal_length_size; i-- > 0;) {
+            packet.push_back(static_cast<uint8_t>(nal.size() >> (8 * i)));
+        }
+        packet.insert(packet.end(), nal.begin(), nal.end());
+    }
+    return packet;
+}
+
+const std::vector<uint8_t> kExpected = {0, 0, 0, 1, 0x67, 0x42, 0x00,
+                                        0, 0, 0, 1, 0x65, 0x88};
+} // namespace
+
+TEST(AnnexbTest, SizeCountsStartCodes) {
+    EXPECT_EQ(avcc_to_annexb_size(make_avcc(4), 4), kExpected.size());
+    EXPECT_EQ(avcc_to_annexb_size(make_avcc(2), 2), kExpected.size());
+    EXPECT_EQ(avcc_to_annexb_size(make_avcc(1), 1), kExpected.size());
+}
+
+TEST(AnnexbTest, ConvertsShortPrefixes) {
+    for (size_t nal_length_size : {1u, 2u}) {
+        const auto avcc = make_avcc(nal_length_size);
+        std::vector<uint8_t> out(*avcc_to_annexb_size(avcc, nal_length_size));
+
+        avcc_to_annexb(avcc, nal_length_size, out);
+
+        EXPECT_EQ(out, kExpected) << "nal_length_size " << nal_length_size;
+    }
+}
+
+TEST(AnnexbTest, ConvertsFourBytePrefixesInPlace) {
+    auto data = make_avcc(4);
+
+    const auto size = avcc_to_annexb_in_place(data);
+
+    ASSERT_TRUE(size.has_value());
+    EXPECT_EQ(*size, data.size());
+    EXPECT_EQ(data, kExpected);
+}
+
+TEST(AnnexbTest, TrailingBytesAreDropped) {
+    auto data = make_avcc(4);
+    data.push_back(0xaa); // Shorter than a length prefix
+
+    EXPECT_EQ(avcc_to_annexb_size(data, 4), kExpected.size());
+    EXPECT_EQ(avcc_to_annexb_in_place(data), kExpected.size());
+}
+
+TEST(AnnexbTest, OverlongNalIsRejected) {
+    auto data = make_avcc(4);
+    data[3] = 0x40; // First NAL claims 64 bytes
+
+    EXPECT_FALSE(avcc_to_annexb_size(data, 4).has_value());
+    EXPECT_FALSE(avcc_to_annexb_in_place(data).has_value());
+}
+
+TEST(AnnexbTest, InvalidLengthSizeIsRejected) {
+    EXPECT_FALSE(avcc_to_annexb_size(make_avcc(4), 0).has_value());
+    EXPECT_FALSE(avcc_to_annexb_size(make_avcc(4), 5).has_value());
+}
+
+TEST(AnnexbTest, EmptyPacketConvertsToNothing) {
+    std::vector<uint8_t> data;
+
+    EXPECT_EQ(avcc_to_annexb_size(data, 4), 0u);
+    EXPECT_EQ(avcc_to_annexb_in_place(data), 0u);
+}
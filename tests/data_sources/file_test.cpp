@@ -248,4 +248,38 @@ TEST_F(FileDataSourceTest, EmptyFileReturnsZeroAvailable) {
     std::filesystem::remove(empty_file_path);
 }
 
+TEST_F(FileDataSourceTest, SizeIsKnownOnlyWhileOpen) {
+    file source(m_test_file_path);
+    EXPECT_FALSE(source.size().has_value());
+
+    source.open();
+    EXPECT_EQ(source.size(), m_test_data.size());
+}
+
+TEST_F(FileDataSourceTest, SeekMovesReadPosition) {
+    file source(m_test_file_path);
+    source.open();
+
+    // Read to EOF first: seeking must clear the stream's EOF state
+    std::vector<uint8_t> buffer(m_test_data.size());
+    source.read_data(buffer.size(), buffer);
+
+    ASSERT_TRUE(source.seek(200));
+    EXPECT_EQ(source.available(), m_test_data.size() - 200);
+    ASSERT_EQ(source.read_data(10, buffer), 10);
+    EXPECT_EQ(buffer[0], m_test_data[200]);
+
+    ASSERT_TRUE(source.seek(16));
+    source.read_data(1, buffer);
+    EXPECT_EQ(buffer[0], m_test_data[16]);
+}
+
+TEST_F(FileDataSourceTest, SeekPastEndFails) {
+    file source(m_test_file_path);
+    source.open();
+
+    EXPECT_TRUE(source.seek(m_test_data.size()));
+    EXPECT_FALSE(source.seek(m_test_data.size() + 1));
+}
+
 } // namespace yapl::data_sources::test
@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+
+#include "loopback_http_server.hpp"
+#include "yapl/detail/data_sources/http.hpp"
+
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__SANITIZE_THREAD__)
+#define YAPL_TEST_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define YAPL_TEST_TSAN 1
+#endif
+#endif
+
+namespace yapl::data_sources::test {
+
+namespace {
+constexpr size_t kKiB = 1024;
+constexpr size_t kMiB = 1024 * kKiB;
+
+// Small ring so tests run through many pause/resume cycles
+constexpr source_config kSmallRing{.http_buffer_size = 1 * kMiB,
+                                   .http_back_buffer_size = 256 * kKiB};
+
+// Current resident set size of the process. getrusage() only reports the
+// peak over the whole process, which earlier tests may already have set.
+size_t resident_bytes() {
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+    std::ifstream("/proc/self/statm") >> total_pages >> resident_pages;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Hands memory freed by earlier tests back to the kernel, so that a later
+// allocation shows up in the RSS instead of reusing resident heap pages
+void release_free_heap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+// Reads size bytes, failing the test on a short read or wrong content
+void expect_read(http &source, size_t offset, size_t size) {
+    std::vector<uint8_t> buffer(size);
+    size_t done = 0;
+    while (done < size) {
+        const size_t read = source.read_data(
+            size - done, std::span{buffer}.subspan(done));
+        ASSERT_GT(read, 0u) << "unexpected EOF at " << offset + done;
+        done += read;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(buffer[i], loopback_http_server::byte_at(offset + i))
+            << "at offset " << offset + i;
+    }
+}
+} // namespace
+
+TEST(HttpDataSourceTest, ReadsResourceLargerThanRing) {
+    loopback_http_server server(8 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    EXPECT_EQ(source.size(), 8 * kMiB);
+    expect_read(source, 0, 8 * kMiB);
+
+    std::vector<uint8_t> buffer(16);
+    EXPECT_EQ(source.read_data(buffer.size(), buffer), 0u);
+    EXPECT_EQ(server.request_count(), 1u);
+}
+
+TEST(HttpDataSourceTest, FullRingPausesDownload) {
+    loopback_http_server server(64 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    // Nothing is read, so the download must stop once the ring is full
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LE(source.available(), source.capacity());
+
+    expect_read(source, 0, 4 * kMiB);
+    EXPECT_LE(source.available(), source.capacity());
+}
+
+TEST(HttpDataSourceTest, CapacityKeepsRoomForBackBuffer) {
+    const source_config config{.http_buffer_size = 64 * kKiB,
+                               .http_back_buffer_size = 512 * kKiB};
+    http source("http://127.0.0.1:1/unused", config);
+
+    EXPECT_EQ(source.capacity(),
+              512 * kKiB + 2 * http::kTransferChunkSize);
+}
+
+TEST(HttpDataSourceTest, SeekWithinBackBufferReusesRing) {
+    loopback_http_server server(4 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    expect_read(source, 0, 600 * kKiB);
+    ASSERT_TRUE(source.seek(500 * kKiB));
+    expect_read(source, 500 * kKiB, 300 * kKiB);
+
+    EXPECT_EQ(server.request_count(), 1u);
+}
+
+TEST(HttpDataSourceTest, SeekBehindBackBufferUsesRangeRequest) {
+    loopback_http_server server(4 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    expect_read(source, 0, 2 * kMiB);
+    ASSERT_TRUE(source.seek(100 * kKiB));
+    expect_read(source, 100 * kKiB, 64 * kKiB);
+
+    EXPECT_EQ(server.request_count(), 2u);
+    EXPECT_EQ(source.size(), 4 * kMiB);
+}
+
+TEST(HttpDataSourceTest, SeekAheadOfDownloadUsesRangeRequest) {
+    loopback_http_server server(16 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    ASSERT_TRUE(source.seek(12 * kMiB));
+    expect_read(source, 12 * kMiB, 4 * kMiB);
+
+    EXPECT_EQ(server.request_count(), 2u);
+}
+
+TEST(HttpDataSourceTest, SeekOutsideRingFailsWithoutRangeSupport) {
+    loopback_http_server server(4 * kMiB, false);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    expect_read(source, 0, 2 * kMiB);
+    EXPECT_FALSE(source.seek(0));
+    EXPECT_TRUE(source.seek(2 * kMiB - 64 * kKiB));
+    expect_read(source, 2 * kMiB - 64 * kKiB, 64 * kKiB);
+}
+
+TEST(HttpDataSourceTest, ParallelSegmentsUseConcurrentConnections) {
+    loopback_http_server server(8 * kMiB);
+    server.set_response_delay(std::chrono::milliseconds(20));
+    const source_config config{.http_buffer_size = 4 * kMiB,
+                               .http_back_buffer_size = 256 * kKiB,
+                               .http_connections = 4,
+                               .http_segment_size = 256 * kKiB};
+    http source(server.url(), config);
+    source.open();
+
+    expect_read(source, 0, 8 * kMiB);
+    EXPECT_EQ(source.size(), 8 * kMiB);
+    EXPECT_EQ(server.request_count(), 32u);
+    EXPECT_GE(server.peak_concurrent_requests(), 2u);
+}
+
+TEST(HttpDataSourceTest, ParallelSegmentsRespectRing) {
+    loopback_http_server server(16 * kMiB);
+    http source(server.url(),
+                {.http_buffer_size = 1 * kMiB,
+                 .http_back_buffer_size = 256 * kKiB,
+                 .http_connections = 8,
+                 .http_segment_size = 256 * kKiB});
+    source.open();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_LE(server.bytes_sent(), 2 * kMiB);
+    expect_read(source, 0, 16 * kMiB);
+}
+
+TEST(HttpDataSourceTest, ParallelSeekRestartsSegments) {
+    loopback_http_server server(16 * kMiB);
+    http source(server.url(),
+                {.http_connections = 4, .http_segment_size = 1 * kMiB});
+    source.open();
+
+    expect_read(source, 0, 1 * kMiB);
+    ASSERT_TRUE(source.seek(10 * kMiB + 123));
+    expect_read(source, 10 * kMiB + 123, 2 * kMiB);
+    ASSERT_TRUE(source.seek(16 * kMiB));
+    std::vector<uint8_t> buffer(16);
+    EXPECT_EQ(source.read_data(buffer.size(), buffer), 0u);
+}
+
+TEST(HttpDataSourceTest, ParallelFallsBackWithoutRangeSupport) {
+    loopback_http_server server(4 * kMiB, false);
+    http source(server.url(),
+                {.http_buffer_size = 1 * kMiB,
+                 .http_back_buffer_size = 256 * kKiB,
+                 .http_connections = 4,
+                 .http_segment_size = 256 * kKiB});
+    source.open();
+
+    expect_read(source, 0, 4 * kMiB);
+    EXPECT_EQ(server.request_count(), 1u);
+}
+
+TEST(HttpDataSourceTest, ResetUsesRangeRequest) {
+    loopback_http_server server(8 * kMiB);
+    http source(server.url(), kSmallRing);
+    source.open();
+
+    expect_read(source, 0, 4 * kMiB);
+    source.reset();
+    expect_read(source, 0, 64 * kKiB);
+    EXPECT_EQ(server.request_count(), 2u);
+}
+
+TEST(HttpDataSourceTest, OpenWaitsForMinimumBuffer) {
+    loopback_http_server server(8 * kMiB);
+    server.set_rate_limit(2 * kMiB);
+    http source(server.url(), {.http_buffer_min_kb = 256});
+    source.open();
+
+    EXPECT_GE(source.available(), 256 * kKiB);
+    EXPECT_LT(source.available(), 8 * kMiB);
+}
+
+TEST(HttpDataSourceTest, ZeroMinimumReturnsOnceHeadersArrive) {
+    loopback_http_server server(8 * kMiB);
+    server.set_rate_limit(256 * kKiB);
+    http source(server.url(), {.http_buffer_min_kb = 0});
+    source.open();
+
+    // The size comes from the headers, long before the body is in
+    EXPECT_EQ(source.size(), 8 * kMiB);
+    EXPECT_LT(source.available(), 1 * kMiB);
+    expect_read(source, 0, 16 * kKiB);
+}
+
+TEST(HttpDataSourceTest, LongStreamKeepsMemoryBounded) {
+#ifdef YAPL_TEST_TSAN
+    GTEST_SKIP() << "ThreadSanitizer shadow memory inflates RSS";
+#endif
+    constexpr size_t kStreamSize = 256 * kMiB;
+    constexpr size_t kSampleInterval = 4 * kMiB;
+    loopback_http_server server(kStreamSize);
+
+    // open() allocates and zero-fills the whole ring; measure that on its own
+    // so the streaming figure below is not hidden in it
+    release_free_heap();
+    const size_t rss_before = resident_bytes();
+    http source(server.url());
+    source.open();
+    const size_t rss_open = resident_bytes();
+    size_t rss_peak = rss_open;
+
+    std::vector<uint8_t> buffer(64 * kKiB);
+    size_t total = 0;
+    size_t next_sample = kSampleInterval;
+    while (const size_t read = source.read_data(buffer.size(), buffer)) {
+        total += read;
+        if (total >= next_sample) {
+            rss_peak = std::max(rss_peak, resident_bytes());
+            next_sample = total + kSampleInterval;
+        }
+    }
+    source.close();
+
+    const size_t ring_growth =
+        rss_open > rss_before ? rss_open - rss_before : 0;
+    const size_t stream_growth = rss_peak - rss_open;
+    RecordProperty("ring_capacity_kb",
+                   std::to_string(source.capacity() / kKiB));
+    RecordProperty("ring_rss_growth_kb", std::to_string(ring_growth / kKiB));
+    RecordProperty("stream_rss_growth_kb",
+                   std::to_string(stream_growth / kKiB));
+
+    EXPECT_EQ(total, kStreamSize);
+    // The ring plus the transfer thread's stack and curl state
+    EXPECT_LT(ring_growth, source.capacity() + 16 * kMiB);
+    // Streaming 16x the ring must not grow memory beyond it
+    EXPECT_LT(stream_growth, 16 * kMiB);
+}
+
+} // namespace yapl::data_sources::test
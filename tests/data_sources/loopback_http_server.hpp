@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace yapl::data_sources::test {
+
+/**
+ * @brief Minimal HTTP/1.1 server on 127.0.0.1 for data source tests
+ *
+ * Serves a generated resource of a given size, or given content, at any
+ * path, one thread per connection. "Range: bytes=N-" and "bytes=N-M"
+ * requests get a 206 when ranges are enabled; everything else gets the whole
+ * body. A response delay and a per-connection rate limit stand in for a
+ * distant server.
+ */
+class loopback_http_server {
+  public:
+    explicit loopback_http_server(size_t size, bool accept_ranges = true)
+        : m_size{size}, m_accept_ranges{accept_ranges} {
+        listen();
+    }
+
+    explicit loopback_http_server(std::vector<uint8_t> content,
+                                  bool accept_ranges = true)
+        : m_content{std::move(content)}, m_size{m_content.size()},
+          m_accept_ranges{accept_ranges} {
+        listen();
+    }
+
+    ~loopback_http_server() {
+        m_stopping = true;
+        ::shutdown(m_listen_fd, SHUT_RDWR);
+        m_accept_thread.join();
+        ::close(m_listen_fd);
+
+        {
+            std::lock_guard lock(m_mutex);
+            for (int fd : m_connections) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    loopback_http_server(const loopback_http_server &) = delete;
+    loopback_http_server &operator=(const loopback_http_server &) = delete;
+
+    // Content of the generated resource at offset
+    static uint8_t byte_at(size_t offset) {
+        return static_cast<uint8_t>((offset * 31) ^ (offset >> 12));
+    }
+
+    [[nodiscard]] std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + "/media.bin";
+    }
+
+    // Wait before answering each request
+    void set_response_delay(std::chrono::milliseconds delay) {
+        m_response_delay = delay;
+    }
+
+    // Bytes per second each connection may send, 0 for unlimited
+    void set_rate_limit(size_t bytes_per_second) {
+        m_rate_limit = bytes_per_second;
+    }
+
+    [[nodiscard]] size_t request_count() const { return m_requests; }
+    [[nodiscard]] size_t bytes_sent() const { return m_bytes_sent; }
+    // Most requests that were being answered at the same time
+    [[nodiscard]] size_t peak_concurrent_requests() const {
+        return m_peak_active;
+    }
+
+  private:
+    void listen() {
+        m_listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (m_listen_fd < 0) {
+            throw std::runtime_error("socket() failed");
+        }
+        const int reuse = 1;
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse,
+                   sizeof(reuse));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (::bind(m_listen_fd, reinterpret_cast<sockaddr *>(&address),
+                   sizeof(address)) != 0 ||
+            ::listen(m_listen_fd, 16) != 0 ||
+            ::getsockname(m_listen_fd, reinterpret_cast<sockaddr *>(&address),
+                          &length) != 0) {
+            ::close(m_listen_fd);
+            throw std::runtime_error("Failed to listen on loopback");
+        }
+        m_port = ntohs(address.sin_port);
+        m_accept_thread = std::thread(&loopback_http_server::accept_loop,
+                                      this);
+    }
+
+    void accept_loop() {
+        while (!m_stopping) {
+            const int fd = ::accept(m_listen_fd, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            std::lock_guard lock(m_mutex);
+            m_connections.push_back(fd);
+            m_threads.emplace_back(&loopback_http_server::serve, this, fd);
+        }
+    }
+
+    void serve(int fd) {
+        std::string request;
+        char chunk[1024];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                finish(fd);
+                return;
+            }
+            request.append(chunk, static_cast<size_t>(received));
+        }
+        ++m_requests;
+        const size_t active = ++m_active;
+        size_t peak = m_peak_active;
+        while (active > peak &&
+               !m_peak_active.compare_exchange_weak(peak, active)) {
+        }
+        std::this_thread::sleep_for(m_response_delay.load());
+
+        size_t first = 0;
+        size_t last = m_size == 0 ? 0 : m_size - 1;
+        const bool ranged = m_accept_ranges && parse_range(request, first,
+                                                           last);
+        const size_t length = m_size == 0 ? 0 : last - first + 1;
+
+        std::string header = ranged ? "HTTP/1.1 206 Partial Content\r\n"
+                                    : "HTTP/1.1 200 OK\r\n";
+        header += "Content-Length: " + std::to_string(length) + "\r\n";
+        if (ranged) {
+            header += "Content-Range: bytes " + std::to_string(first) + "-" +
+                      std::to_string(last) + "/" + std::to_string(m_size) +
+                      "\r\n";
+        }
+        if (m_accept_ranges) {
+            header += "Accept-Ranges: bytes\r\n";
+        }
+        header += "Connection: close\r\n\r\n";
+
+        if (send_all(fd, header.data(), header.size())) {
+            std::vector<uint8_t> body(16 * 1024);
+            const auto started = std::chrono::steady_clock::now();
+            for (size_t offset = first; offset < first + length;) {
+                if (const size_t rate = m_rate_limit) {
+                    std::this_thread::sleep_until(
+                        started + std::chrono::microseconds(
+                                      (offset - first) * 1'000'000 / rate));
+                }
+                const size_t count =
+                    std::min(body.size(), first + length - offset);
+                for (size_t i = 0; i < count; ++i) {
+                    body[i] = m_content.empty() ? byte_at(offset + i)
+                                                : m_content[offset + i];
+                }
+                if (!send_all(fd, body.data(), count)) {
+                    break;
+                }
+                offset += count;
+                m_bytes_sent += count;
+            }
+        }
+        --m_active;
+        finish(fd);
+    }
+
+    // Clamps "bytes=N-" / "bytes=N-M" to the resource; false without one
+    bool parse_range(const std::string &request, size_t &first,
+                     size_t &last) const {
+        std::string lower(request);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        const auto at = lower.find("\r\nrange: bytes=");
+        if (at == std::string::npos) {
+            return false;
+        }
+        const char *spec = request.c_str() + at + 15;
+        char *end = nullptr;
+        first = std::strtoull(spec, &end, 10);
+        if (*end != '-' || first >= m_size) {
+            return false;
+        }
+        if (std::isdigit(static_cast<unsigned char>(end[1]))) {
+            last = std::min<size_t>(std::strtoull(end + 1, nullptr, 10),
+                                    m_size - 1);
+        }
+        return first <= last;
+    }
+
+    static bool send_all(int fd, const void *data, size_t size) {
+        const auto *bytes = static_cast<const char *>(data);
+        while (size > 0) {
+            const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return false;
+            }
+            bytes += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    void finish(int fd) {
+        std::lock_guard lock(m_mutex);
+        m_connections.erase(
+            std::find(m_connections.begin(), m_connections.end(), fd));
+        ::close(fd);
+    }
+
+    std::vector<uint8_t> m_content;
+    size_t m_size;
+    bool m_accept_ranges;
+    int m_listen_fd{-1};
+    uint16_t m_port{0};
+    std::atomic_bool m_stopping{false};
+    std::atomic<size_t> m_requests{0};
+    std::atomic<size_t> m_bytes_sent{0};
+    std::atomic<size_t> m_active{0};
+    std::atomic<size_t> m_peak_active{0};
+    std::atomic<std::chrono::milliseconds> m_response_delay{};
+    std::atomic<size_t> m_rate_limit{0};
+
+    std::mutex m_mutex;
+    std::vector<int> m_connections;
+    std::vector<std::thread> m_threads;
+    std::thread m_accept_thread;
+};
+
+} // namespace yapl::data_sources::test
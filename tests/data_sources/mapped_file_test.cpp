@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include "yapl/detail/data_sources/factory.hpp"
+#include "yapl/detail/data_sources/mapped_file.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace yapl::data_sources::test {
+
+class MappedFileDataSourceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_test_file_path =
+            std::filesystem::temp_directory_path() / "yapl_mapped_test.bin";
+        std::ofstream file(m_test_file_path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(m_test_data.data()),
+                   m_test_data.size());
+        file.close();
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(m_test_file_path)) {
+            std::filesystem::remove(m_test_file_path);
+        }
+    }
+
+    std::filesystem::path m_test_file_path;
+    std::array<uint8_t, 256> m_test_data = []() {
+        std::array<uint8_t, 256> data{};
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<uint8_t>(i);
+        }
+        return data;
+    }();
+};
+
+TEST_F(MappedFileDataSourceTest, OpenMapsWholeFile) {
+    mapped_file source(m_test_file_path);
+    ASSERT_NO_THROW(source.open());
+
+    EXPECT_TRUE(source.is_open());
+    EXPECT_EQ(source.available(), m_test_data.size());
+    ASSERT_EQ(source.mapping().size(), m_test_data.size());
+    EXPECT_TRUE(std::equal(m_test_data.begin(), m_test_data.end(),
+                           source.mapping().begin()));
+}
+
+TEST_F(MappedFileDataSourceTest, OpenThrowsOnInvalidFile) {
+    mapped_file source("/nonexistent/path/to/file.bin");
+    EXPECT_THROW(source.open(), std::runtime_error);
+    EXPECT_FALSE(source.is_open());
+}
+
+TEST_F(MappedFileDataSourceTest, CloseUnmapsFile) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    source.close();
+    EXPECT_FALSE(source.is_open());
+    EXPECT_TRUE(source.mapping().empty());
+}
+
+TEST_F(MappedFileDataSourceTest, SequentialReadsAreCorrect) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    std::vector<uint8_t> buffer(100);
+    size_t total_read = 0;
+    while (const size_t bytes_read = source.read_data(100, buffer)) {
+        for (size_t i = 0; i < bytes_read; ++i) {
+            ASSERT_EQ(buffer[i], m_test_data[total_read + i]);
+        }
+        total_read += bytes_read;
+    }
+
+    EXPECT_EQ(total_read, m_test_data.size());
+    EXPECT_EQ(source.available(), 0);
+}
+
+TEST_F(MappedFileDataSourceTest, ReadDataThrowsOnSmallBuffer) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    std::vector<uint8_t> small_buffer(10);
+    EXPECT_THROW(source.read_data(100, small_buffer), std::invalid_argument);
+}
+
+TEST_F(MappedFileDataSourceTest, ReadDataThrowsWhenNotOpen) {
+    mapped_file source(m_test_file_path);
+
+    std::vector<uint8_t> buffer(10);
+    EXPECT_THROW(source.read_data(10, buffer), std::runtime_error);
+}
+
+TEST_F(MappedFileDataSourceTest, ConsumeReturnsMappedBytes) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    source.consume(16);
+    const auto data = source.consume(32);
+
+    ASSERT_EQ(data.size(), 32);
+    EXPECT_EQ(data.data(), source.mapping().data() + 16);
+    EXPECT_EQ(data[0], m_test_data[16]);
+    EXPECT_EQ(source.available(), m_test_data.size() - 48);
+}
+
+TEST_F(MappedFileDataSourceTest, ConsumeClampsAtEndOfFile) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    source.consume(250);
+    EXPECT_EQ(source.consume(100).size(), 6);
+    EXPECT_TRUE(source.consume(100).empty());
+}
+
+TEST_F(MappedFileDataSourceTest, ResetResetsPosition) {
+    mapped_file source(m_test_file_path);
+    source.open();
+
+    std::vector<uint8_t> buffer(100);
+    source.read_data(100, buffer);
+    source.reset();
+
+    EXPECT_EQ(source.available(), m_test_data.size());
+    source.read_data(10, buffer);
+    EXPECT_EQ(buffer[0], m_test_data[0]);
+}
+
+TEST_F(MappedFileDataSourceTest, SeekMovesReadPosition) {
+    mapped_file source(m_test_file_path);
+    source.open();
+    EXPECT_EQ(source.size(), m_test_data.size());
+
+    ASSERT_TRUE(source.seek(200));
+    EXPECT_EQ(source.consume(1)[0], m_test_data[200]);
+    ASSERT_TRUE(source.seek(3));
+    EXPECT_EQ(source.consume(1)[0], m_test_data[3]);
+    EXPECT_FALSE(source.seek(m_test_data.size() + 1));
+}
+
+TEST_F(MappedFileDataSourceTest, MoveTransfersMapping) {
+    mapped_file source1(m_test_file_path);
+    source1.open();
+    source1.consume(10);
+
+    mapped_file source2(std::move(source1));
+    EXPECT_TRUE(source2.is_open());
+    EXPECT_EQ(source2.available(), m_test_data.size() - 10);
+
+    mapped_file source3(m_test_file_path);
+    source3 = std::move(source2);
+    EXPECT_TRUE(source3.is_open());
+    EXPECT_EQ(source3.consume(1)[0], m_test_data[10]);
+}
+
+TEST_F(MappedFileDataSourceTest, EmptyFileOpensWithNothingToRead) {
+    const auto empty_file_path =
+        std::filesystem::temp_directory_path() / "yapl_mapped_empty.bin";
+    std::ofstream(empty_file_path, std::ios::binary).close();
+
+    mapped_file source(empty_file_path);
+    source.open();
+
+    EXPECT_TRUE(source.is_open());
+    EXPECT_EQ(source.available(), 0);
+    std::vector<uint8_t> buffer(10);
+    EXPECT_EQ(source.read_data(10, buffer), 0);
+
+    std::filesystem::remove(empty_file_path);
+}
+
+TEST_F(MappedFileDataSourceTest, FactorySelectsMappedFileByScheme) {
+    auto source = create("file+mmap://" + m_test_file_path.string());
+    ASSERT_TRUE(std::holds_alternative<std::unique_ptr<mapped_file>>(source));
+
+    visit(source, [](auto &ds) { ds.open(); });
+    EXPECT_EQ(visit(source, [](const auto &ds) { return ds.available(); }),
+              m_test_data.size());
+
+    EXPECT_TRUE(std::holds_alternative<std::unique_ptr<file>>(
+        create(m_test_file_path.string())));
+}
+
+} // namespace yapl::data_sources::test
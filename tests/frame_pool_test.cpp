@@ -0,0 +1,174 @@
+#include "yapl/detail/blocking_queue.hpp"
+#include "yapl/detail/frame_pool.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+constexpr frame_key k720p{
+    .format = sample_format::yuv420p, .width = 1280, .height = 720};
+constexpr frame_key k1080p{
+    .format = sample_format::yuv420p, .width = 1920, .height = 1080};
+constexpr size_t k720pSize = 1280 * 720 * 3 / 2;
+} // namespace
+
+TEST(FramePoolTest, AcquireProvidesRequestedSize) {
+    frame_pool pool;
+
+    auto frame = pool.acquire(k720p, k720pSize);
+
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->data.size(), k720pSize);
+    EXPECT_EQ(pool.stats().allocations, 1u);
+}
+
+TEST(FramePoolTest, ReleasedFrameIsReused) {
+    frame_pool pool;
+
+    auto frame = pool.acquire(k720p, k720pSize);
+    const auto *buffer = frame->data.data();
+    frame->pts = 1000;
+    frame.reset();
+    EXPECT_EQ(pool.stats().free_frames, 1u);
+
+    frame = pool.acquire(k720p, k720pSize);
+    EXPECT_EQ(frame->data.data(), buffer);
+    EXPECT_EQ(frame->pts, 0);
+
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.allocations, 1u);
+    EXPECT_EQ(stats.reuses, 1u);
+    EXPECT_EQ(stats.free_frames, 0u);
+}
+
+TEST(FramePoolTest, FrameReturnsOnlyAfterLastReference) {
+    frame_pool pool;
+
+    auto frame = pool.acquire(k720p, k720pSize);
+    auto renderer_ref = frame;
+    frame.reset();
+    EXPECT_EQ(pool.stats().free_frames, 0u);
+
+    renderer_ref.reset();
+    EXPECT_EQ(pool.stats().free_frames, 1u);
+}
+
+TEST(FramePoolTest, KeyChangeDropsStaleFrames) {
+    frame_pool pool;
+
+    auto old_frame = pool.acquire(k720p, k720pSize);
+    pool.acquire(k720p, k720pSize).reset();
+    EXPECT_EQ(pool.stats().free_frames, 1u);
+
+    auto frame = pool.acquire(k1080p, 1920 * 1080 * 3 / 2);
+    EXPECT_EQ(pool.stats().free_frames, 0u);
+
+    // Frames of the previous key still in flight are not recycled either
+    old_frame.reset();
+    EXPECT_EQ(pool.stats().free_frames, 0u);
+    EXPECT_EQ(pool.stats().allocations, 3u);
+}
+
+TEST(FramePoolTest, ZeroSizeKeepsRecycledCapacity) {
+    frame_pool pool;
+    const frame_key audio{
+        .format = sample_format::f32_interleaved, .width = 2, .height = 44100};
+
+    auto frame = pool.acquire(audio, 0);
+    EXPECT_TRUE(frame->data.empty());
+    frame->data.resize(8192);
+    frame.reset();
+
+    frame = pool.acquire(audio, 0);
+    EXPECT_EQ(frame->data.size(), 8192u);
+}
+
+TEST(FramePoolTest, FreeListIsBounded) {
+    frame_pool pool{2};
+
+    std::vector<std::shared_ptr<media_sample>> frames;
+    for (int i = 0; i < 4; ++i) {
+        frames.push_back(pool.acquire(k720p, 16));
+    }
+    frames.clear();
+
+    EXPECT_EQ(pool.stats().free_frames, 2u);
+}
+
+TEST(FramePoolTest, FramesOutliveThePool) {
+    std::shared_ptr<media_sample> frame;
+    {
+        frame_pool pool;
+        frame = pool.acquire(k720p, k720pSize);
+    }
+    EXPECT_EQ(frame->data.size(), k720pSize);
+    frame.reset();
+}
+
+TEST(FramePoolTest, ConcurrentAcquireAndRelease) {
+    frame_pool pool;
+    blocking_queue<std::shared_ptr<media_sample>> frames{4};
+    constexpr int kNumFrames = 10000;
+
+    std::thread decoder([&]() {
+        for (int i = 0; i < kNumFrames; ++i) {
+            auto frame = pool.acquire(k720p, 64);
+            frame->pts = i;
+            ASSERT_TRUE(frames.push(frame));
+        }
+    });
+
+    for (int i = 0; i < kNumFrames; ++i) {
+        auto frame = frames.pop();
+        ASSERT_TRUE(frame.has_value());
+        ASSERT_EQ((*frame)->pts, i);
+    }
+    decoder.join();
+
+    // Queue capacity plus the frame held on each side
+    auto stats = pool.stats();
+    EXPECT_EQ(stats.allocations + stats.reuses,
+              static_cast<size_t>(kNumFrames));
+    EXPECT_LE(stats.allocations, 6u);
+}
+
+TEST(FramePoolTest, RecycleReleasesReferencedPlanes) {
+    frame_pool pool;
+    auto decoder_memory = std::make_shared<std::vector<uint8_t>>(64);
+
+    auto frame = pool.acquire(k720p, 0);
+    frame->planes.data[0] = decoder_memory->data();
+    frame->planes.linesize[0] = 64;
+    frame->planes.owner = decoder_memory;
+    EXPECT_EQ(decoder_memory.use_count(), 2);
+
+    frame.reset();
+    EXPECT_EQ(decoder_memory.use_count(), 1);
+
+    frame = pool.acquire(k720p, 0);
+    EXPECT_TRUE(frame->planes.empty());
+}
+
+TEST(FramePoolTest, RecycleKeepsReusableOwner) {
+    frame_pool pool;
+    static int releases = 0;
+    releases = 0;
+    auto shell = std::make_shared<std::vector<uint8_t>>(64);
+
+    auto frame = pool.acquire(k720p, 0);
+    frame->planes.data[0] = shell->data();
+    frame->planes.linesize[0] = 64;
+    frame->planes.owner = shell;
+    frame->planes.release = [](void *) { ++releases; };
+
+    frame.reset();
+    EXPECT_EQ(releases, 1);
+    EXPECT_EQ(shell.use_count(), 2);
+
+    frame = pool.acquire(k720p, 0);
+    EXPECT_TRUE(frame->planes.empty());
+    EXPECT_EQ(frame->planes.owner, shell);
+}
@@ -0,0 +1,83 @@
+#include "yapl/keyframe_index.hpp"
+#include <gtest/gtest.h>
+
+using namespace yapl;
+
+namespace {
+// Keyframes every 2s at 0, 2000, 4000, 6000
+keyframe_index make_index() {
+    keyframe_index index;
+    for (int64_t i = 0; i < 4; ++i) {
+        index.add({.pts_ms = i * 2000, .byte_offset = i * 100000, .size = 5000});
+    }
+    return index;
+}
+} // namespace
+
+TEST(KeyframeIndexTest, EmptyIndexFindsNothing) {
+    keyframe_index index;
+
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.at_or_before(1000).has_value());
+    EXPECT_FALSE(index.after(1000).has_value());
+    EXPECT_FALSE(index.before(1000).has_value());
+}
+
+TEST(KeyframeIndexTest, AtOrBeforeFindsTheGopStart) {
+    const auto index = make_index();
+
+    EXPECT_EQ(index.at_or_before(4000)->pts_ms, 4000);
+    EXPECT_EQ(index.at_or_before(5999)->pts_ms, 4000);
+    EXPECT_EQ(index.at_or_before(99999)->pts_ms, 6000);
+    EXPECT_FALSE(index.at_or_before(-1).has_value());
+}
+
+TEST(KeyframeIndexTest, BeforeAndAfterAreStrict) {
+    const auto index = make_index();
+
+    EXPECT_EQ(index.before(4000)->pts_ms, 2000);
+    EXPECT_EQ(index.after(4000)->pts_ms, 6000);
+    EXPECT_FALSE(index.before(0).has_value());
+    EXPECT_FALSE(index.after(6000).has_value());
+}
+
+TEST(KeyframeIndexTest, EntriesKeepOffsetAndSize) {
+    const auto index = make_index();
+
+    const auto entry = index.at_or_before(2500);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->byte_offset, 100000);
+    EXPECT_EQ(entry->size, 5000u);
+}
+
+TEST(KeyframeIndexTest, OutOfOrderAddsStaySorted) {
+    keyframe_index index;
+    index.add({.pts_ms = 4000});
+    index.add({.pts_ms = 0});
+    index.add({.pts_ms = 2000});
+
+    ASSERT_EQ(index.size(), 3u);
+    EXPECT_EQ(index.entries()[0].pts_ms, 0);
+    EXPECT_EQ(index.entries()[1].pts_ms, 2000);
+    EXPECT_EQ(index.entries()[2].pts_ms, 4000);
+}
+
+TEST(KeyframeIndexTest, ReplayedKeyframesAreNotDuplicated) {
+    auto index = make_index();
+
+    // Playback after seeking back demuxes the same keyframes again
+    index.add({.pts_ms = 2000, .byte_offset = 100000});
+    index.add({.pts_ms = 6000, .byte_offset = 300000});
+
+    EXPECT_EQ(index.size(), 4u);
+}
+
+TEST(KeyframeIndexTest, ClearResetsSource) {
+    auto index = make_index();
+    index.set_from_container(true);
+
+    index.clear();
+
+    EXPECT_TRUE(index.empty());
+    EXPECT_FALSE(index.from_container());
+}
@@ -0,0 +1,133 @@
+#include "yapl/detail/latency_histogram.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace yapl;
+
+TEST(LatencyHistogramTest, EmptySnapshotIsZero) {
+    latency_histogram histogram;
+
+    const auto stats = histogram.snapshot();
+
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_EQ(stats.p50_us, 0);
+    EXPECT_EQ(stats.max_us, 0);
+    EXPECT_EQ(stats.to_string(), "-");
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    latency_histogram histogram;
+    for (int64_t us = 1; us <= 20; ++us) {
+        histogram.record_us(us);
+    }
+
+    const auto stats = histogram.snapshot();
+
+    EXPECT_EQ(stats.count, 20u);
+    EXPECT_EQ(stats.p50_us, 10);
+    EXPECT_EQ(stats.p95_us, 19);
+    EXPECT_EQ(stats.max_us, 20);
+}
+
+TEST(LatencyHistogramTest, PercentilesStayWithinBucketPrecision) {
+    latency_histogram histogram;
+    for (int64_t us = 1; us <= 100'000; ++us) {
+        histogram.record_us(us);
+    }
+
+    const auto stats = histogram.snapshot();
+
+    EXPECT_EQ(stats.count, 100'000u);
+    EXPECT_NEAR(stats.p50_us, 50'000, 50'000 / 16);
+    EXPECT_NEAR(stats.p95_us, 95'000, 95'000 / 16);
+    EXPECT_NEAR(stats.p99_us, 99'000, 99'000 / 16);
+    EXPECT_GE(stats.p99_us, 99'000);
+    EXPECT_EQ(stats.max_us, 100'000);
+}
+
+TEST(LatencyHistogramTest, TailShowsInHighPercentiles) {
+    latency_histogram histogram;
+    for (int i = 0; i < 980; ++i) {
+        histogram.record_us(100);
+    }
+    for (int i = 0; i < 20; ++i) {
+        histogram.record_us(40'000);
+    }
+
+    const auto stats = histogram.snapshot();
+
+    EXPECT_LE(stats.p95_us, 110);
+    EXPECT_GE(stats.p99_us, 40'000);
+    EXPECT_EQ(stats.max_us, 40'000);
+}
+
+TEST(LatencyHistogramTest, OutOfRangeValuesAreClamped) {
+    latency_histogram histogram;
+    histogram.record_us(-5);
+    histogram.record_us(std::numeric_limits<int64_t>::max());
+
+    const auto stats = histogram.snapshot();
+
+    EXPECT_EQ(stats.count, 2u);
+    EXPECT_EQ(stats.p50_us, 0);
+    EXPECT_EQ(stats.max_us,
+              static_cast<int64_t>(latency_histogram::kMaxValueUs));
+}
+
+TEST(LatencyHistogramTest, BucketsCoverTheWholeRange) {
+    EXPECT_EQ(latency_histogram::bucket_index(latency_histogram::kMaxValueUs),
+              latency_histogram::kBucketCount - 1);
+    EXPECT_EQ(latency_histogram::bucket_upper_bound(
+                  latency_histogram::kBucketCount - 1),
+              latency_histogram::kMaxValueUs);
+    // Consecutive buckets tile the value range without gaps
+    for (size_t i = 1; i < latency_histogram::kBucketCount; ++i) {
+        const auto first = latency_histogram::bucket_upper_bound(i - 1) + 1;
+        ASSERT_EQ(latency_histogram::bucket_index(first), i);
+    }
+}
+
+TEST(LatencyHistogramTest, RecordsDurations) {
+    latency_histogram histogram;
+    histogram.record(std::chrono::milliseconds(3));
+
+    EXPECT_EQ(histogram.snapshot().max_us, 3000);
+}
+
+TEST(LatencyHistogramTest, ResetClearsSamples) {
+    latency_histogram histogram;
+    histogram.record_us(500);
+    histogram.reset();
+
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+    EXPECT_EQ(histogram.snapshot().max_us, 0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreNotLost) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 100'000;
+    latency_histogram histogram;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                histogram.record_us(t * 1000 + i % 1000);
+            }
+        });
+    }
+    // Snapshots may run while other threads record
+    while (histogram.snapshot().count < kThreads * kPerThread / 2) {
+        std::this_thread::yield();
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto stats = histogram.snapshot();
+    EXPECT_EQ(stats.count, static_cast<size_t>(kThreads * kPerThread));
+    EXPECT_EQ(stats.max_us, (kThreads - 1) * 1000 + 999);
+}
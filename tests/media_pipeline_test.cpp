@@ -0,0 +1,181 @@
+#include "yapl/decoders/i_decoder.hpp"
+#include "yapl/decoders/i_decoder_factory.hpp"
+#include "yapl/detail/media_pipeline.hpp"
+#include "yapl/i_media_extractor.hpp"
+#include "yapl/i_media_extractor_factory.hpp"
+#include "yapl/i_media_source.hpp"
+#include "yapl/i_media_source_factory.hpp"
+#include "yapl/input/i_input_handler.hpp"
+#include "yapl/input/i_input_handler_factory.hpp"
+#include "yapl/media_info.hpp"
+#include "yapl/media_sample.hpp"
+#include "yapl/pipeline_config.hpp"
+#include "yapl/renderers/null/audio_renderer_factory.hpp"
+#include "yapl/renderers/null/video_renderer_factory.hpp"
+#include "yapl/track_info.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+using namespace yapl;
+
+namespace {
+constexpr size_t kAudioFrames = 200;
+// 1024 samples at 44.1 kHz
+constexpr int64_t kAudioFrameMs = 23;
+
+struct null_source : i_media_source {
+    void open(const std::string_view) override {}
+    void close() override {}
+    size_t read_packet(size_t, std::span<uint8_t>) override { return 0; }
+    size_t available() const override { return 0; }
+    void reset() override {}
+    bool seek(size_t) override { return false; }
+    std::optional<size_t> size() const override { return std::nullopt; }
+};
+
+struct null_source_factory : i_media_source_factory {
+    std::shared_ptr<i_media_source> create(const source_config &) override {
+        return std::make_shared<null_source>();
+    }
+};
+
+// One audio track of kAudioFrames packets, then end of stream
+struct audio_only_extractor : i_media_extractor {
+    void start() override {
+        auto audio = std::make_shared<track_info>();
+        audio->type = track_type::audio;
+        audio->track_id = 0;
+        audio->audio = std::make_shared<audio_track_uniques>(
+            audio_track_uniques{.sample_rate = 44100,
+                                .channels = 2,
+                                .bit_rate = 0,
+                                .extra_data = std::make_shared<audio_extra_data>(
+                                    std::span<uint8_t>{})});
+
+        m_info = std::make_shared<media_info>();
+        m_info->number_of_tracks = 1;
+        m_info->tracks.push_back(audio);
+    }
+
+    std::shared_ptr<media_info> get_media_info() const override {
+        return m_info;
+    }
+
+    read_sample_result read_sample() override {
+        if (m_next_packet >= kAudioFrames) {
+            return {.stream_id = 0,
+                    .error = read_sample_error_t::end_of_stream,
+                    .sample = {}};
+        }
+        auto packet = std::make_shared<media_sample>();
+        packet->pts = static_cast<int64_t>(m_next_packet++) * kAudioFrameMs;
+        return {.stream_id = 0,
+                .error = read_sample_error_t::no_errror,
+                .sample = packet};
+    }
+
+    bool seek(int64_t) override { return false; }
+    keyframe_index get_keyframe_index(size_t) const override { return {}; }
+    extractor_startup_stats get_startup_stats() const override { return {}; }
+
+    std::shared_ptr<media_info> m_info;
+    size_t m_next_packet{0};
+};
+
+struct audio_only_extractor_factory : i_media_extractor_factory {
+    std::unique_ptr<i_media_extractor>
+    create(std::shared_ptr<i_media_source>,
+           const extractor_config &) override {
+        return std::make_unique<audio_only_extractor>();
+    }
+};
+
+// Every packet decodes to one frame with the same pts
+struct passthrough_decoder : decoders::i_decoder {
+    bool decode(std::shared_ptr<track_info>,
+                std::shared_ptr<media_sample> sample,
+                const decoders::frame_callback &on_frame) override {
+        auto frame = std::make_shared<media_sample>();
+        frame->pts = sample->pts;
+        on_frame(std::move(frame));
+        return true;
+    }
+    bool flush(const decoders::frame_callback &) override { return true; }
+    void reset() override {}
+};
+
+struct passthrough_decoder_factory : decoders::i_decoder_factory {
+    std::unique_ptr<decoders::i_decoder>
+    create_video_decoder(size_t, std::span<uint8_t>,
+                         const decoder_threading &) override {
+        return std::make_unique<passthrough_decoder>();
+    }
+    std::unique_ptr<decoders::i_decoder>
+    create_audio_decoder(size_t, std::span<uint8_t>) override {
+        return std::make_unique<passthrough_decoder>();
+    }
+};
+
+// Quits from the render loop once done() holds, or after a deadline so a
+// stalled pipeline fails the test instead of hanging it
+struct quit_when : input::i_input_handler {
+    explicit quit_when(std::function<bool()> done) : m_done{std::move(done)} {}
+    void poll() override {
+        if (m_callback &&
+            (m_done() || std::chrono::steady_clock::now() > m_deadline)) {
+            m_callback(input::command::quit);
+        }
+    }
+    void set_command_callback(input::command_callback callback) override {
+        m_callback = std::move(callback);
+    }
+    std::function<bool()> m_done;
+    std::chrono::steady_clock::time_point m_deadline{
+        std::chrono::steady_clock::now() + std::chrono::seconds(10)};
+    input::command_callback m_callback;
+};
+
+struct quit_when_factory : input::i_input_handler_factory {
+    explicit quit_when_factory(std::function<bool()> done)
+        : m_done{std::move(done)} {}
+    std::unique_ptr<input::i_input_handler> create() override {
+        return std::make_unique<quit_when>(m_done);
+    }
+    std::function<bool()> m_done;
+};
+} // namespace
+
+TEST(MediaPipelineTest, FreeRunningAudioOnlyPlaysEveryFrame) {
+    pipeline_config config;
+    config.playback_clock = clock_mode::free_running;
+    const auto pacing = renderers::null::render_pacing::clock;
+
+    media_pipeline *running = nullptr;
+    const auto all_played = [&running] {
+        const auto audio = running->get_stats().playback.audio;
+        return audio.rendered + audio.dropped_late == kAudioFrames;
+    };
+    media_pipeline pipeline{
+        std::make_unique<null_source_factory>(),
+        std::make_unique<audio_only_extractor_factory>(),
+        std::make_unique<passthrough_decoder_factory>(),
+        std::make_unique<renderers::null::video_renderer_factory>(pacing),
+        std::make_unique<renderers::null::audio_renderer_factory>(pacing),
+        std::make_unique<quit_when_factory>(all_played),
+        config};
+    running = &pipeline;
+    pipeline.set_command_callback([&](input::command cmd) {
+        if (cmd == input::command::quit) {
+            pipeline.stop();
+        }
+    });
+
+    pipeline.load("synthetic://audio-only");
+    pipeline.play();
+
+    const auto audio = pipeline.get_stats().playback.audio;
+    EXPECT_EQ(audio.dropped_late, 0u);
+    EXPECT_EQ(audio.rendered, kAudioFrames);
+}
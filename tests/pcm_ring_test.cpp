@@ -0,0 +1,137 @@
+#include "yapl/detail/pcm_ring.hpp"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+std::vector<uint8_t> make_bytes(size_t count, uint8_t first = 0) {
+    std::vector<uint8_t> bytes(count);
+    std::iota(bytes.begin(), bytes.end(), first);
+    return bytes;
+}
+} // namespace
+
+TEST(PcmRingTest, WriteThenRead) {
+    pcm_ring ring{16};
+    const auto in = make_bytes(10);
+
+    EXPECT_EQ(ring.write(in), 10u);
+    EXPECT_EQ(ring.size(), 10u);
+
+    std::vector<uint8_t> out(10);
+    EXPECT_EQ(ring.read(out), 10u);
+    EXPECT_EQ(out, in);
+    EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(PcmRingTest, ZeroCapacityThrows) {
+    EXPECT_THROW(pcm_ring{0}, std::invalid_argument);
+}
+
+TEST(PcmRingTest, ReadReturnsWhatIsBuffered) {
+    pcm_ring ring{16};
+    ring.write(make_bytes(4));
+
+    std::vector<uint8_t> out(8, 0xff);
+    EXPECT_EQ(ring.read(out), 4u);
+
+    EXPECT_EQ(ring.read(out), 0u);
+}
+
+TEST(PcmRingTest, WrapsAroundTheEnd) {
+    pcm_ring ring{8};
+    std::vector<uint8_t> out(6);
+
+    ring.write(make_bytes(6));
+    ring.read(out);
+
+    const auto in = make_bytes(6, 100);
+    ring.write(in); // Straddles the end of the buffer
+    ring.read(out);
+
+    EXPECT_EQ(out, in);
+}
+
+TEST(PcmRingTest, OffsetsCountStreamBytes) {
+    pcm_ring ring{8};
+    std::vector<uint8_t> out(5);
+
+    ring.write(make_bytes(6));
+    ring.read(out);
+    ring.write(make_bytes(6));
+
+    EXPECT_EQ(ring.bytes_written(), 12u);
+    EXPECT_EQ(ring.bytes_read(), 5u);
+    EXPECT_EQ(ring.size(), 7u);
+}
+
+TEST(PcmRingTest, ClearDropsBufferedBytes) {
+    pcm_ring ring{8};
+
+    ring.write(make_bytes(6));
+    ring.clear();
+
+    EXPECT_EQ(ring.size(), 0u);
+    EXPECT_EQ(ring.bytes_read(), 6u);
+}
+
+TEST(PcmRingTest, ShutdownUnblocksWriter) {
+    pcm_ring ring{4};
+    size_t written = 0;
+
+    std::thread producer([&] { written = ring.write(make_bytes(10)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring.shutdown();
+    producer.join();
+
+    EXPECT_EQ(written, 4u);
+    EXPECT_TRUE(ring.is_shutdown());
+}
+
+TEST(PcmRingTest, ClearUnblocksParkedWriter) {
+    pcm_ring ring{4};
+    size_t written = 0;
+
+    std::thread producer([&] { written = ring.write(make_bytes(10)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring.clear();
+    producer.join();
+
+    // The rest of the interrupted write is dropped, not queued after clear()
+    EXPECT_EQ(written, 4u);
+    EXPECT_EQ(ring.size(), 0u);
+    EXPECT_FALSE(ring.is_shutdown());
+    EXPECT_EQ(ring.write(make_bytes(3)), 3u);
+    EXPECT_EQ(ring.size(), 3u);
+}
+
+TEST(PcmRingTest, ProducerConsumerPreserveOrder) {
+    constexpr size_t kTotal = 1 << 20;
+    pcm_ring ring{1000};
+    const auto in = make_bytes(kTotal);
+
+    std::thread producer([&] {
+        // Odd chunk sizes so writes straddle the end of the buffer
+        for (size_t pos = 0; pos < kTotal; pos += 333) {
+            const auto chunk = std::min<size_t>(333, kTotal - pos);
+            ring.write(std::span{in}.subspan(pos, chunk));
+        }
+    });
+
+    std::vector<uint8_t> out;
+    out.reserve(kTotal);
+    std::vector<uint8_t> chunk(257);
+    while (out.size() < kTotal) {
+        const auto got = ring.read(chunk);
+        out.insert(out.end(), chunk.begin(), chunk.begin() + got);
+        if (got == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(out, in);
+}
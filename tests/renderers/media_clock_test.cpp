@@ -108,6 +108,27 @@ TEST(MediaClockTest, GetAudioLatency) {
     EXPECT_EQ(clock.get_audio_latency_ms(), 0);
 }
 
+TEST(MediaClockTest, AudioPositionIsPublished) {
+    media_clock clock;
+
+    EXPECT_FALSE(clock.get_audio_position_ms().has_value());
+
+    clock.set_audio_position_ms(1234);
+    EXPECT_EQ(clock.get_audio_position_ms(), 1234);
+
+    clock.set_audio_position_ms(std::nullopt);
+    EXPECT_FALSE(clock.get_audio_position_ms().has_value());
+}
+
+TEST(MediaClockTest, ResetClearsAudioPosition) {
+    media_clock clock;
+
+    clock.set_audio_position_ms(500);
+    clock.reset();
+
+    EXPECT_FALSE(clock.get_audio_position_ms().has_value());
+}
+
 TEST(MediaClockTest, MultipleStartCallsIdempotent) {
     media_clock clock;
 
@@ -140,3 +161,133 @@ TEST(MediaClockTest, PauseAndResumePreservesElapsedTime) {
     // Total elapsed should be ~40ms (20 + 20), not including pause duration
     EXPECT_NEAR(time_after_resume, 40, 10);
 }
+
+TEST(MediaClockTest, RebaseStopsClockAtNewPosition) {
+    media_clock clock;
+
+    clock.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    clock.rebase(5000);
+
+    EXPECT_FALSE(clock.is_started());
+    EXPECT_EQ(clock.get_time_ms(), 5000);
+
+    clock.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_GT(clock.get_time_ms(), 5005);
+    EXPECT_LT(clock.get_time_ms(), 5500);
+}
+
+TEST(MediaClockTest, RebaseBackwardKeepsPauseState) {
+    media_clock clock;
+
+    clock.rebase(10000);
+    clock.start();
+    clock.pause();
+    clock.rebase(2000);
+
+    EXPECT_TRUE(clock.is_paused());
+    EXPECT_EQ(clock.get_time_ms(), 2000);
+}
+
+TEST(MediaClockTest, ResetClearsRebase) {
+    media_clock clock;
+
+    clock.rebase(3000);
+    clock.reset();
+
+    EXPECT_EQ(clock.get_time_ms(), 0);
+}
+
+TEST(MediaClockTest, FreeRunningIgnoresWallTime) {
+    media_clock clock{yapl::clock_mode::free_running};
+
+    clock.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    EXPECT_EQ(clock.get_time_ms(), 0);
+}
+
+TEST(MediaClockTest, FreeRunningAdvancesForwardOnly) {
+    media_clock clock{yapl::clock_mode::free_running};
+
+    clock.advance_to(500); // Before start(): ignored
+    EXPECT_EQ(clock.get_time_ms(), 0);
+
+    clock.start();
+    clock.advance_to(40);
+    EXPECT_EQ(clock.get_time_ms(), 40);
+
+    clock.advance_to(20);
+    EXPECT_EQ(clock.get_time_ms(), 40);
+
+    clock.pause();
+    clock.advance_to(80);
+    EXPECT_EQ(clock.get_time_ms(), 40);
+}
+
+TEST(MediaClockTest, FreeRunningRebaseRestartsFromPosition) {
+    media_clock clock{yapl::clock_mode::free_running};
+
+    clock.start();
+    clock.advance_to(1000);
+    clock.rebase(5000);
+    clock.start();
+
+    EXPECT_EQ(clock.get_time_ms(), 5000);
+    clock.advance_to(5040);
+    EXPECT_EQ(clock.get_time_ms(), 5040);
+}
+
+TEST(MediaClockTest, RealtimeIgnoresAdvance) {
+    media_clock clock;
+
+    clock.start();
+    clock.advance_to(60000);
+
+    EXPECT_LT(clock.get_time_ms(), 1000);
+}
+
+TEST(MediaClockTest, AudioMasterJumpsToDistantAudio) {
+    media_clock clock{yapl::clock_mode::audio_master};
+
+    clock.start();
+    clock.follow_audio(2000);
+
+    EXPECT_GE(clock.get_time_ms(), 2000);
+    EXPECT_LT(clock.get_time_ms(), 2100);
+    EXPECT_GE(clock.get_audio_correction_ms(), 1900);
+}
+
+TEST(MediaClockTest, AudioMasterSlewsSmallErrors) {
+    media_clock clock{yapl::clock_mode::audio_master};
+
+    clock.rebase(1000);
+    clock.start();
+    const auto before = clock.get_time_ms();
+
+    clock.follow_audio(before + 80);
+
+    // Only a share of the 80ms error is applied at once
+    EXPECT_GE(clock.get_time_ms(), before + 10);
+    EXPECT_LT(clock.get_time_ms(), before + 40);
+}
+
+TEST(MediaClockTest, AudioMasterVideoTimeIgnoresLatency) {
+    media_clock clock{yapl::clock_mode::audio_master};
+
+    clock.rebase(500);
+    clock.set_audio_latency_ms(100);
+
+    EXPECT_EQ(clock.get_video_time_ms(), 500);
+}
+
+TEST(MediaClockTest, RealtimeIgnoresFollowAudio) {
+    media_clock clock;
+
+    clock.start();
+    clock.follow_audio(60000);
+
+    EXPECT_LT(clock.get_time_ms(), 1000);
+    EXPECT_EQ(clock.get_audio_correction_ms(), 0);
+}
@@ -0,0 +1,108 @@
+#include "yapl/renderers/null/audio_renderer.hpp"
+#include "yapl/renderers/null/video_renderer.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace yapl;
+using namespace yapl::renderers;
+
+namespace {
+std::shared_ptr<media_sample> make_frame(int64_t pts) {
+    auto frame = std::make_shared<media_sample>();
+    frame->pts = pts;
+    return frame;
+}
+} // namespace
+
+TEST(NullRendererTest, FastVideoConsumesEverythingQueued) {
+    media_clock clock;
+    null::video_renderer renderer{clock, 16, queue_kind::spsc,
+                                  null::render_pacing::as_fast_as_possible};
+
+    for (int64_t pts = 0; pts < 10'000; pts += 1000) {
+        renderer.push_frame(make_frame(pts));
+    }
+    EXPECT_TRUE(renderer.get_next_frame_due_ms().has_value());
+
+    renderer.render();
+
+    EXPECT_EQ(renderer.get_render_counters().rendered, 10u);
+    EXPECT_EQ(renderer.get_render_counters().dropped_late, 0u);
+    EXPECT_EQ(renderer.get_current_position_ms(), 9000);
+    EXPECT_EQ(renderer.get_queue_stats().size, 0u);
+    EXPECT_TRUE(renderer.get_first_frame_time().has_value());
+    EXPECT_FALSE(renderer.get_next_frame_due_ms().has_value());
+}
+
+TEST(NullRendererTest, ClockVideoWaitsForDueFrames) {
+    media_clock clock;
+    null::video_renderer renderer{clock, 16, queue_kind::blocking,
+                                  null::render_pacing::clock};
+
+    renderer.push_frame(make_frame(0));
+    renderer.push_frame(make_frame(10'000));
+
+    renderer.render();
+    renderer.render();
+
+    EXPECT_EQ(renderer.get_render_counters().rendered, 1u);
+    EXPECT_EQ(renderer.get_next_frame_due_ms(), 10'000 - 15);
+}
+
+TEST(NullRendererTest, ClockVideoDropsLateFrames) {
+    media_clock clock;
+    clock.rebase(5000);
+    null::video_renderer renderer{clock, 16, queue_kind::blocking,
+                                  null::render_pacing::clock};
+
+    renderer.push_frame(make_frame(0));
+    renderer.render();
+
+    EXPECT_EQ(renderer.get_render_counters().rendered, 0u);
+    EXPECT_EQ(renderer.get_render_counters().dropped_late, 1u);
+}
+
+TEST(NullRendererTest, FlushDropsQueuedFrames) {
+    media_clock clock;
+    null::video_renderer renderer{clock, 16, queue_kind::spsc,
+                                  null::render_pacing::as_fast_as_possible};
+
+    renderer.push_frame(make_frame(0));
+    renderer.push_frame(make_frame(40));
+    renderer.flush();
+    renderer.render();
+
+    EXPECT_EQ(renderer.get_render_counters().rendered, 0u);
+}
+
+TEST(NullRendererTest, FastAudioConsumesEverythingQueued) {
+    media_clock clock;
+    null::audio_renderer renderer{clock, 16, queue_kind::spsc,
+                                  null::render_pacing::as_fast_as_possible};
+
+    for (int64_t pts = 0; pts < 5000; pts += 1000) {
+        renderer.push_frame(make_frame(pts));
+    }
+    renderer.render();
+
+    EXPECT_EQ(renderer.get_render_counters().rendered, 5u);
+    EXPECT_EQ(renderer.get_render_counters().underruns, 0u);
+    EXPECT_EQ(renderer.get_queue_latency().count, 5u);
+}
+
+TEST(NullRendererTest, ClockAudioPublishesPosition) {
+    media_clock clock;
+    null::audio_renderer renderer{clock, 16, queue_kind::blocking,
+                                  null::render_pacing::clock};
+
+    renderer.push_frame(make_frame(0));
+    renderer.push_frame(make_frame(10'000));
+    renderer.render();
+
+    EXPECT_TRUE(clock.is_started());
+    EXPECT_EQ(renderer.get_render_counters().rendered, 1u);
+    EXPECT_EQ(clock.get_audio_position_ms(), 0);
+
+    renderer.flush();
+    EXPECT_FALSE(clock.get_audio_position_ms().has_value());
+}
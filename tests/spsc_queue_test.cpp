@@ -0,0 +1,179 @@
+#include "yapl/detail/pipeline_queue.hpp"
+#include "yapl/detail/spsc_queue.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace yapl;
+
+TEST(SpscQueueTest, PushAndPopBasic) {
+    spsc_queue<int> queue{10};
+
+    queue.push(42);
+    auto result = queue.try_pop();
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 42);
+}
+
+TEST(SpscQueueTest, TryPopReturnsNulloptWhenEmpty) {
+    spsc_queue<int> queue{10};
+
+    auto result = queue.try_pop();
+
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(SpscQueueTest, ZeroCapacityThrows) {
+    EXPECT_THROW(spsc_queue<int>{0}, std::invalid_argument);
+}
+
+TEST(SpscQueueTest, TryPushFailsWhenFull) {
+    spsc_queue<int> queue{2};
+
+    EXPECT_TRUE(queue.try_push(1));
+    EXPECT_TRUE(queue.try_push(2));
+    EXPECT_TRUE(queue.is_full());
+    EXPECT_FALSE(queue.try_push(3));
+
+    queue.try_pop();
+    EXPECT_TRUE(queue.try_push(3));
+}
+
+TEST(SpscQueueTest, StatsReportCorrectValues) {
+    spsc_queue<int> queue{10};
+
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.size, 0u);
+    EXPECT_EQ(stats.capacity, 10u);
+
+    queue.push(1);
+    queue.push(2);
+
+    stats = queue.stats();
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.capacity, 10u);
+}
+
+TEST(SpscQueueTest, FIFOOrderingAcrossWrapAround) {
+    spsc_queue<int> queue{3};
+
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(queue.try_push(round * 3 + i));
+        }
+        for (int i = 0; i < 3; ++i) {
+            auto result = queue.try_pop();
+            ASSERT_TRUE(result.has_value());
+            EXPECT_EQ(*result, round * 3 + i);
+        }
+    }
+}
+
+TEST(SpscQueueTest, ShutdownDrainsThenReturnsNullopt) {
+    spsc_queue<int> queue{10};
+
+    queue.push(1);
+    queue.shutdown();
+
+    EXPECT_TRUE(queue.is_shutdown());
+    EXPECT_FALSE(queue.push(2));
+
+    auto result = queue.pop();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 1);
+
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(SpscQueueTest, ShutdownWakesBlockedConsumer) {
+    spsc_queue<int> queue{10};
+
+    std::thread consumer([&queue]() { EXPECT_FALSE(queue.pop()); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.shutdown();
+    consumer.join();
+}
+
+TEST(SpscQueueTest, ShutdownWakesBlockedProducer) {
+    spsc_queue<int> queue{1};
+    queue.push(1);
+
+    std::thread producer([&queue]() { EXPECT_FALSE(queue.push(2)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.shutdown();
+    producer.join();
+}
+
+TEST(SpscQueueTest, TimedPopReportsTimeoutAndShutdown) {
+    spsc_queue<int> queue{10};
+
+    auto output = queue.pop(std::chrono::milliseconds(5));
+    EXPECT_EQ(output.result, spsc_queue<int>::pop_result::timeout);
+
+    queue.push(7);
+    output = queue.pop(std::chrono::milliseconds(5));
+    EXPECT_EQ(output.result, spsc_queue<int>::pop_result::no_error);
+    ASSERT_TRUE(output.data.has_value());
+    EXPECT_EQ(*output.data, 7);
+
+    queue.shutdown();
+    output = queue.pop(std::chrono::milliseconds(5));
+    EXPECT_EQ(output.result, spsc_queue<int>::pop_result::shutdown);
+}
+
+TEST(SpscQueueTest, ConcurrentBlockingPushAndPop) {
+    spsc_queue<int> queue{8};
+    constexpr int kNumItems = 100000;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < kNumItems; ++i) {
+            ASSERT_TRUE(queue.push(i));
+        }
+    });
+
+    for (int i = 0; i < kNumItems; ++i) {
+        auto item = queue.pop();
+        ASSERT_TRUE(item.has_value());
+        ASSERT_EQ(*item, i) << "Out of order item at index " << i;
+    }
+
+    producer.join();
+    EXPECT_TRUE(queue.is_empty());
+}
+
+TEST(SpscQueueTest, PopReleasesSharedPtr) {
+    spsc_queue<std::shared_ptr<int>> queue{10};
+
+    auto ptr = std::make_shared<int>(42);
+    queue.push(ptr);
+    EXPECT_EQ(ptr.use_count(), 2);
+
+    auto result = queue.try_pop();
+    ASSERT_TRUE(result.has_value());
+    result.reset();
+
+    EXPECT_EQ(ptr.use_count(), 1);
+}
+
+TEST(PipelineQueueTest, DispatchesToSelectedKind) {
+    pipeline_queue<int> blocking{4, queue_kind::blocking};
+    pipeline_queue<int> spsc{4, queue_kind::spsc};
+
+    EXPECT_EQ(blocking.kind(), queue_kind::blocking);
+    EXPECT_EQ(spsc.kind(), queue_kind::spsc);
+
+    for (auto *queue : {&blocking, &spsc}) {
+        queue->push(1);
+        queue->push(2);
+        EXPECT_EQ(queue->stats().size, 2u);
+        EXPECT_EQ(queue->capacity(), 4u);
+        EXPECT_EQ(*queue->try_pop(), 1);
+        EXPECT_EQ(*queue->pop(), 2);
+        queue->shutdown();
+        EXPECT_TRUE(queue->is_shutdown());
+    }
+}
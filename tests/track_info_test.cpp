@@ -0,0 +1,190 @@
+#include "yapl/track_info.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using namespace yapl;
+
+namespace {
+// avcC record: 4-byte lengths, one 4-byte SPS, one 2-byte PPS, then the
+// High profile chroma/bit depth fields
+std::vector<uint8_t> make_avcc_record() {
+    return {0x01, 0x64, 0x00, 0x28, 0xff, 0xe1, 0x00, 0x04, 0x67,
+            0x64, 0x00, 0x28, 0x01, 0x00, 0x02, 0x68, 0xee, 0xfd,
+            0xf8, 0xf8, 0x00};
+}
+
+// hvcC record: Main profile, level 4.0 (120), 4-byte lengths, one VPS, SPS
+// and PPS array
+std::vector<uint8_t> make_hvcc_record() {
+    std::vector<uint8_t> record(23, 0);
+    record[0] = 0x01;
+    record[1] = 0x01; // general_profile_idc
+    record[12] = 120; // general_level_idc
+    record[21] = 0x0f; // lengthSizeMinusOne = 3
+    record[22] = 3;
+    const std::vector<std::vector<uint8_t>> arrays = {
+        {0x20, 0x00, 0x01, 0x00, 0x02, 0x40, 0x01},
+        {0x21, 0x00, 0x01, 0x00, 0x03, 0x42, 0x01, 0x01},
+        {0x22, 0x00, 0x01, 0x00, 0x02, 0x44, 0x01},
+    };
+    for (const auto &array : arrays) {
+        record.insert(record.end(), array.begin(), array.end());
+    }
+    return record;
+}
+
+// av1C record: Main profile, level 8, with a sized sequence header OBU
+std::vector<uint8_t> make_av1c_record() {
+    return {0x81, 0x08, 0x0c, 0x00, 0x0a, 0x03, 0x00, 0x00, 0x00};
+}
+
+video_track_uniques make_video(video_codec codec,
+                               const std::vector<uint8_t> &record,
+                               video_bitstream bitstream) {
+    video_track_uniques video{};
+    video.extra_data = std::make_shared<video_extra_data>(codec, record);
+    video.bitstream = bitstream;
+    return video;
+}
+} // namespace
+
+TEST(TrackInfoTest, ParsesAvccRecord) {
+    const video_extra_data extra{video_codec::h264, make_avcc_record()};
+
+    EXPECT_EQ(extra.nal_size_length, 4);
+    EXPECT_EQ(extra.profile, 0x64);
+    EXPECT_EQ(extra.level, 0x28);
+    EXPECT_EQ(extra.bit_depth, 8);
+    EXPECT_EQ(extra.sps_length, 4);
+    EXPECT_EQ(extra.pps_length, 2);
+    EXPECT_EQ(extra.pps_data, (std::vector<uint8_t>{0x68, 0xee}));
+}
+
+TEST(TrackInfoTest, PassthroughDecoderConfigIsTheRecord) {
+    const auto video = make_video(video_codec::h264, make_avcc_record(),
+                                  video_bitstream::passthrough);
+
+    EXPECT_EQ(video.get_decoder_config(), make_avcc_record());
+}
+
+TEST(TrackInfoTest, AnnexbDecoderConfigIsStartCodeParameterSets) {
+    const auto video = make_video(video_codec::h264, make_avcc_record(),
+                                  video_bitstream::annexb);
+
+    const std::vector<uint8_t> expected = {0, 0, 0, 1, 0x67, 0x64, 0x00, 0x28,
+                                           0, 0, 0, 1, 0x68, 0xee};
+    EXPECT_EQ(video.get_decoder_config(), expected);
+}
+
+TEST(TrackInfoTest, TruncatedAvccIsPassedThrough) {
+    auto record = make_avcc_record();
+    record.resize(10); // Cuts the SPS short
+
+    const video_extra_data extra{video_codec::h264, record};
+
+    EXPECT_EQ(extra.nal_size_length, 0);
+    EXPECT_TRUE(extra.parameter_sets.empty());
+    EXPECT_EQ(extra.raw_data, record);
+}
+
+TEST(TrackInfoTest, AnnexbExtradataIsNotParsed) {
+    const std::vector<uint8_t> annexb = {0, 0, 0, 1, 0x67, 0x42, 0, 0, 0, 1,
+                                         0x68, 0xce};
+
+    const video_extra_data extra{video_codec::h264, annexb};
+
+    EXPECT_EQ(extra.nal_size_length, 0);
+    EXPECT_EQ(extra.raw_data, annexb);
+}
+
+TEST(TrackInfoTest, EmptyExtradata) {
+    const video_extra_data extra{video_codec::h264, {}};
+
+    EXPECT_EQ(extra.nal_size_length, 0);
+    EXPECT_TRUE(extra.raw_data.empty());
+}
+
+TEST(TrackInfoTest, ParsesHvccRecord) {
+    const video_extra_data extra{video_codec::hevc, make_hvcc_record()};
+
+    EXPECT_EQ(extra.nal_size_length, 4);
+    EXPECT_EQ(extra.profile, 1);
+    EXPECT_EQ(extra.level, 120);
+    EXPECT_EQ(extra.bit_depth, 8);
+    ASSERT_EQ(extra.parameter_sets.size(), 3u);
+    EXPECT_EQ(extra.sps_data, (std::vector<uint8_t>{0x42, 0x01, 0x01}));
+    EXPECT_EQ(extra.pps_data, (std::vector<uint8_t>{0x44, 0x01}));
+}
+
+TEST(TrackInfoTest, ParsesHvccMain10BitDepth) {
+    auto record = make_hvcc_record();
+    record[1] = 0x02;  // Main10
+    record[17] = 0xfa; // bitDepthLumaMinus8 = 2
+
+    const video_extra_data extra{video_codec::hevc, record};
+
+    EXPECT_EQ(extra.profile, 2);
+    EXPECT_EQ(extra.bit_depth, 10);
+    EXPECT_EQ(extra.nal_size_length, 4);
+}
+
+TEST(TrackInfoTest, HevcAnnexbDecoderConfigIncludesVps) {
+    const auto video = make_video(video_codec::hevc, make_hvcc_record(),
+                                  video_bitstream::annexb);
+
+    const std::vector<uint8_t> expected = {0, 0, 0, 1, 0x40, 0x01,
+                                           0, 0, 0, 1, 0x42, 0x01, 0x01,
+                                           0, 0, 0, 1, 0x44, 0x01};
+    EXPECT_EQ(video.get_decoder_config(), expected);
+}
+
+TEST(TrackInfoTest, ParsesAv1cConfigObus) {
+    const video_extra_data extra{video_codec::av1, make_av1c_record()};
+
+    EXPECT_EQ(extra.configuration_version, 1);
+    EXPECT_EQ(extra.profile, 0);
+    EXPECT_EQ(extra.level, 8);
+    EXPECT_EQ(extra.bit_depth, 8);
+    EXPECT_EQ(extra.nal_size_length, 0);
+    ASSERT_EQ(extra.parameter_sets.size(), 1u);
+    EXPECT_EQ(extra.parameter_sets[0],
+              (std::vector<uint8_t>{0x0a, 0x03, 0x00, 0x00, 0x00}));
+}
+
+TEST(TrackInfoTest, ParsesAv1cHighBitDepth) {
+    auto record = make_av1c_record();
+    record[2] = 0x4c; // high_bitdepth
+
+    EXPECT_EQ((video_extra_data{video_codec::av1, record}.bit_depth), 10);
+
+    record[2] = 0x6c; // high_bitdepth and twelve_bit
+    EXPECT_EQ((video_extra_data{video_codec::av1, record}.bit_depth), 12);
+}
+
+TEST(TrackInfoTest, Av1DecoderConfigIsAlwaysTheRecord) {
+    const auto video = make_video(video_codec::av1, make_av1c_record(),
+                                  video_bitstream::annexb);
+
+    EXPECT_EQ(video.get_decoder_config(), make_av1c_record());
+}
+
+TEST(TrackInfoTest, OverlongAv1ObuIsRejected) {
+    auto record = make_av1c_record();
+    record[5] = 0x10; // OBU claims 16 bytes
+
+    const video_extra_data extra{video_codec::av1, record};
+
+    EXPECT_TRUE(extra.parameter_sets.empty());
+    EXPECT_EQ(extra.configuration_version, 0);
+}
+
+TEST(TrackInfoTest, Vp9ExtradataIsKeptAsIs) {
+    const std::vector<uint8_t> vpcc = {0x01, 0x00, 0x00, 0x00, 0x00, 0x1f};
+
+    const video_extra_data extra{video_codec::vp9, vpcc};
+
+    EXPECT_EQ(extra.nal_size_length, 0);
+    EXPECT_TRUE(extra.parameter_sets.empty());
+    EXPECT_EQ(extra.raw_data, vpcc);
+}